@@ -1,5 +1,8 @@
 #include "Board.h"
 #include "Side.h"
+#include "BoardLayout.h"
+#include <cstring>
+#include <utility>
 
 Board::Board(int nHoles, int nInitialBeansPerHole)
 // Construct a Board with the indicated number of holes per side (not counting the pot) and
@@ -10,52 +13,110 @@ Board::Board(int nHoles, int nInitialBeansPerHole)
         nHoles = 1;
     if (nInitialBeansPerHole < 0) // if nInitialBeansPerHole is neg
         nInitialBeansPerHole = 0;
-    m_holes = nHoles;
-    // create a dummy Node for the linked list
-    m_head = new Node;
-    m_head->m_next = m_head;
-    m_head->m_prev = m_head;
-    // m_items = 0;
-    // create NORTH pot
-    insertNode(m_head, 0, NORTH, 0);
-    // create NORTH holes
-    for (int i = 0; i < nHoles; i++)
-    {
-        Node* previous = m_head->m_prev; // points to previous last item
-        insertNode(previous, nInitialBeansPerHole, NORTH, i + 1);
-    }
-    // create SOUTH pot
-    insertNode(m_head->m_prev, 0, SOUTH, 0);
-    // create SOUTH holes
-    for (int i = nHoles; i > 0; i--)
+    allocate(nHoles);
+    // every hole starts with nInitialBeansPerHole beans, both pots start empty
+    for (int k = 0; k < nSlots(); k++)
+        m_slots[k] = nInitialBeansPerHole;
+    m_slots[potSlot(SOUTH)] = 0;
+    m_slots[potSlot(NORTH)] = 0;
+    m_inPlay[SOUTH] = m_inPlay[NORTH] = nHoles * nInitialBeansPerHole;
+    m_total = 2 * nHoles * nInitialBeansPerHole;
+    m_hash = hashSlots(DynamicLayout(nHoles), m_slots);
+}
+
+Board::Board(int nHoles, const int slotBeans[])
+// Construct a Board with the indicated number of holes per side (which must be positive)
+// whose holes and pots hold the numbers of beans in slotBeans, given in the order of the
+// slot array (see BoardLayout.h): SOUTH's holes 1..nHoles, SOUTH's pot, NORTH's holes
+// nHoles..1, NORTH's pot. A negative number of beans is taken as 0.
+{
+    allocate(nHoles);
+    DynamicLayout lay(nHoles);
+    m_inPlay[SOUTH] = m_inPlay[NORTH] = 0;
+    m_total = 0;
+    for (int k = 0; k < nSlots(); k++)
     {
-        Node* previous = m_head->m_prev; // points to previous last item
-        insertNode(previous, nInitialBeansPerHole, SOUTH, i);
+        m_slots[k] = (slotBeans[k] > 0 ? slotBeans[k] : 0);
+        if (lay.holeOf(k) != POT)
+            m_inPlay[lay.sideOf(k)] += m_slots[k];
+        m_total += m_slots[k];
     }
+    m_hash = hashSlots(lay, m_slots);
 }
 
 Board::Board(const Board &obj)
 {
-    m_items = obj.m_items;
-    m_holes = obj.m_holes;
-    if (obj.m_head == nullptr)
+    allocate(obj.m_holes);
+    memcpy(m_slots, obj.m_slots, nSlots() * sizeof(int));
+    m_inPlay[SOUTH] = obj.m_inPlay[SOUTH];
+    m_inPlay[NORTH] = obj.m_inPlay[NORTH];
+    m_total = obj.m_total;
+    m_hash = obj.m_hash;
+}
+
+Board::Board(Board &&obj)
+{
+    m_inPlay[SOUTH] = obj.m_inPlay[SOUTH];
+    m_inPlay[NORTH] = obj.m_inPlay[NORTH];
+    m_total = obj.m_total;
+    m_hash = obj.m_hash;
+    if (obj.m_slots == obj.m_inline) // nothing to steal, just copy the inline array
     {
-        m_head = nullptr;
+        allocate(obj.m_holes);
+        memcpy(m_slots, obj.m_slots, nSlots() * sizeof(int));
         return;
     }
-    m_head = new Node; // dummy
-    Node* temp = m_head;
-    for (Node* p = obj.m_head->m_next; p != obj.m_head; p = p->m_next)
+    // take over obj's heap array and leave obj as an empty 1-hole board
+    m_slots = obj.m_slots;
+    m_holes = obj.m_holes;
+    obj.allocate(1);
+    memset(obj.m_slots, 0, obj.nSlots() * sizeof(int));
+    obj.m_inPlay[SOUTH] = obj.m_inPlay[NORTH] = obj.m_total = 0;
+    obj.m_hash = hashSlots(DynamicLayout(1), obj.m_slots);
+}
+
+Board& Board::operator=(const Board &rhs)
+{
+    if (this != &rhs)
+    {
+        if (m_holes != rhs.m_holes) // reuse the storage we have when the sizes match
+        {
+            release();
+            allocate(rhs.m_holes);
+        }
+        memcpy(m_slots, rhs.m_slots, nSlots() * sizeof(int));
+        m_inPlay[SOUTH] = rhs.m_inPlay[SOUTH];
+        m_inPlay[NORTH] = rhs.m_inPlay[NORTH];
+        m_total = rhs.m_total;
+        m_hash = rhs.m_hash;
+    }
+    return *this;
+}
+
+Board& Board::operator=(Board &&rhs)
+{
+    if (this != &rhs)
     {
-        temp->m_next = new Node;
-        temp->m_next->m_prev = temp;
-        temp->m_next->m_beans = p->m_beans; // set value
-        temp->m_next->m_side = p->m_side;
-        temp->m_next->m_holeNum = p->m_holeNum;
-        temp = temp->m_next; // point to newly created Node
+        if (rhs.m_slots == rhs.m_inline) // nothing to steal, same as copying
+            return *this = rhs;
+        release();
+        m_slots = rhs.m_slots;
+        m_holes = rhs.m_holes;
+        m_inPlay[SOUTH] = rhs.m_inPlay[SOUTH];
+        m_inPlay[NORTH] = rhs.m_inPlay[NORTH];
+        m_total = rhs.m_total;
+        m_hash = rhs.m_hash;
+        rhs.allocate(1);
+        memset(rhs.m_slots, 0, rhs.nSlots() * sizeof(int));
+        rhs.m_inPlay[SOUTH] = rhs.m_inPlay[NORTH] = rhs.m_total = 0;
+        rhs.m_hash = hashSlots(DynamicLayout(1), rhs.m_slots);
     }
-    temp->m_next = m_head; // make last item point to the head
-    m_head->m_prev = temp;
+    return *this;
+}
+
+Board::~Board()
+{
+    release();
 }
 
 int Board::holes() const
@@ -68,34 +129,30 @@ int Board::beans(Side s, int hole) const
 // Return the number of beans in the indicated hole or pot, or −1 if the hole number is
 // invalid.
 {
-    for (Node* p = m_head->m_next; p != m_head; p = p->m_next)
-    {
-        if (p->m_holeNum == hole && p->m_side == s) // found indicated hole/pot
-            return p->m_beans;
-    }
-    return -1; // hole/pot number invalid
+    int k = slot(s, hole);
+    if (k == -1) // hole/pot number invalid
+        return -1;
+    return m_slots[k];
 }
 
 int Board::beansInPlay(Side s) const
 // Return the total number of beans in all the holes on the indicated side, not counting the
 // beans in the pot.
 {
-    int totalBeans = 0;
-    for (Node* p = m_head->m_next; p != m_head; p = p->m_next)
-    {
-        if (p->m_side == s && p->m_holeNum != 0) // find correct side and exclude pots
-            totalBeans += p->m_beans;   // count the beans in the holes
-    }
-    return totalBeans;
+    return m_inPlay[s];
 }
 
 int Board::totalBeans() const
 // Return the total number of beans in the game, including any in the pots.
 {
-    int totalBeans = 0;
-    for (Node* p = m_head->m_next; p != m_head; p = p->m_next)
-        totalBeans += p->m_beans;   // count the beans in the holes
-    return totalBeans;
+    return m_total;
+}
+
+std::uint64_t Board::hash() const
+// Return a hash of the position (the number of beans in every hole and pot). Equal positions
+// on boards with the same number of holes have equal hashes.
+{
+    return m_hash;
 }
 
 bool Board::sow(Side s, int hole, Side& endSide, int& endHole)
@@ -107,42 +164,31 @@ bool Board::sow(Side s, int hole, Side& endSide, int& endHole)
 // turns; different Kalah variants have different rules about these issues, so dealing with
 // them should not be the responsibility of the Board class.)
 {
-    for (Node* p = m_head->m_next; p != m_head; p = p->m_next)
-    {
-        if (p->m_holeNum == hole && p->m_side == s && p->m_holeNum != 0 && p->m_beans > 0)
-        {
-            // sow the beans
-            int beansToSow = p->m_beans;
-            // beans are removed from the hole
-            p->m_beans = 0;
-            Node* k = p->m_prev;
-            while(beansToSow > 0)
-            {
-                // if dummy node, don't do anything
-                if (k == m_head)
-                {
-                    k = k->m_prev;
-                    continue;
-                }
-                // if opponent's pot, don't do anything
-                if (k->m_side != s && k->m_holeNum == 0)
-                {
-                    k = k->m_prev;
-                    continue;
-                }
-                // else, place a bean in the hole
-                k->m_beans++;
-                beansToSow--;
-                k = k->m_prev; // move on to the next hole
-            }
-            // finished sowing the beans
-            endSide = k->m_next->m_side;
-            endHole = k->m_next->m_holeNum;
-            return true;
-        }
-    }
-    // indicated hole is empty/invalid/pot
-    return false;
+    int start = slot(s, hole);
+    if (start == -1 || hole == POT || m_slots[start] == 0) // indicated hole is empty/invalid/pot
+        return false;
+    // sow the beans
+    DynamicLayout lay(m_holes);
+    int k = sowSlots(lay, m_slots, m_inPlay, m_hash, s, start);
+    // finished sowing the beans
+    endSide = lay.sideOf(k);
+    endHole = lay.holeOf(k);
+    return true;
+}
+
+bool Board::landing(Side s, int hole, Side& endSide, int& endHole) const
+// If the hole indicated by (s,hole) is empty or invalid or a pot, return false. Otherwise,
+// set endSide and endHole to where the last bean would be placed if the hole were sown, and
+// return true. Nothing is changed.
+{
+    int start = slot(s, hole);
+    if (start == -1 || hole == POT || m_slots[start] == 0) // indicated hole is empty/invalid/pot
+        return false;
+    DynamicLayout lay(m_holes);
+    int k = landingSlot(lay, s, start, m_slots[start]);
+    endSide = lay.sideOf(k);
+    endHole = lay.holeOf(k);
+    return true;
 }
 
 bool Board::moveToPot(Side s, int hole, Side potOwner)
@@ -150,23 +196,16 @@ bool Board::moveToPot(Side s, int hole, Side potOwner)
 // Otherwise, move all the beans in hole (s,hole) into the pot belonging to potOwner and
 // return true.
 {
-    for (Node* p = m_head->m_next; p != m_head; p = p->m_next)
-    {
-        if (p->m_holeNum == hole && p->m_side == s && p->m_holeNum != 0) // found indicated hole
-        {
-            // find the pot
-            for (Node* k = m_head->m_next; k != m_head; k = k-> m_next)
-            {
-                if (k->m_holeNum == 0 && k->m_side == potOwner)
-                {
-                    k->m_beans += p->m_beans; // move all beans in hole to the pot
-                    p->m_beans = 0;
-                    return true;
-                }
-            }
-        }
-    }
-    return false; // hole invalid or a pot
+    int k = slot(s, hole);
+    if (k == -1 || hole == POT) // hole invalid or a pot
+        return false;
+    int pot = potSlot(potOwner);
+    m_hash ^= zobristKey(pot, m_slots[pot]) ^ zobristKey(pot, m_slots[pot] + m_slots[k])
+            ^ zobristKey(k, m_slots[k]) ^ zobristKey(k, 0);
+    m_slots[pot] += m_slots[k]; // move all beans in hole to the pot
+    m_inPlay[s] -= m_slots[k];
+    m_slots[k] = 0;
+    return true;
 }
 
 bool Board::setBeans(Side s, int hole, int beans)
@@ -178,32 +217,82 @@ bool Board::setBeans(Side s, int hole, int beans)
 // member functions of any class is allowed to call this function directly or indirectly.
 // (We'll show an example of its use below.)
 {
-    if (beans < 0) // beans is neg
+    int k = slot(s, hole);
+    if (beans < 0 || k == -1) // beans is neg or indicated hole is invalid
         return false;
-    for (Node* p = m_head->m_next; p != m_head; p = p->m_next)
-    {
-        if (p->m_holeNum == hole && p->m_side == s)
-        {
-            // set the number of beans to the 3rd parameter
-            p->m_beans = beans;
-            return true;
-        }
-    }
-    // indicated hole is invalid
-    return false;
+    // set the number of beans to the 3rd parameter
+    if (hole != POT)
+        m_inPlay[s] += beans - m_slots[k];
+    m_total += beans - m_slots[k];
+    m_hash ^= zobristKey(k, m_slots[k]) ^ zobristKey(k, beans);
+    m_slots[k] = beans;
+    return true;
+}
+
+bool Board::makeMove(Side s, int hole, Undo& undo)
+// If the hole indicated by (s,hole) is empty or invalid or a pot, this function returns false
+// without changing anything. Otherwise, it sows the beans as sow does and then, if the last
+// bean landed in an empty hole of s's and the opponent's hole directly opposite is not
+// empty, moves that bean and the opponent's beans into s's pot (a capture). It fills in undo
+// so that the move can be taken back and returns true. (Extra turns and the end-of-game
+// sweep are left to the caller; undo.extraTurn() tells whether s moves again.)
+{
+    int start = slot(s, hole);
+    if (start == -1 || hole == POT || m_slots[start] == 0) // indicated hole is empty/invalid/pot
+        return false;
+    DynamicLayout lay(m_holes);
+    undo.m_side = s;
+    undo.m_hole = hole;
+    undo.m_sown = m_slots[start];
+    int k = sowSlots(lay, m_slots, m_inPlay, m_hash, s, start);
+    undo.m_endSide = lay.sideOf(k);
+    undo.m_endHole = lay.holeOf(k);
+    undo.m_captured = captureSlots(lay, m_slots, m_inPlay, m_hash, s, k);
+    return true;
+}
+
+void Board::unmakeMove(const Undo& undo)
+// Restore the board exactly as it was before the makeMove call that filled in undo. Moves
+// must be unmade in the reverse of the order in which they were made.
+{
+    DynamicLayout lay(m_holes);
+    Side s = undo.m_side;
+    if (undo.m_captured > 0) // put the captured beans back where they came from
+        uncaptureSlots(lay, m_slots, m_inPlay, m_hash, s, lay.slot(undo.m_endSide, undo.m_endHole), undo.m_captured);
+    unsowSlots(lay, m_slots, m_inPlay, m_hash, s, lay.slot(s, undo.m_hole), undo.m_sown);
 }
 
 //////////
 
-void Board::insertNode(Node* p, const int& beans, const Side& side, const int& holeNum) // adds a new Node to the linked list
-{
-    Node* newNode = new Node; // create a new hole
-    newNode->m_beans = beans; // assign beans
-    newNode->m_side = side; // assign side
-    newNode->m_holeNum = holeNum; // assign holeNum
-    newNode->m_next = m_head;
-    newNode->m_prev = p;
-    newNode->m_prev->m_next = newNode;
-    newNode->m_next->m_prev = newNode;
-    m_items++;
+int Board::slot(Side s, int hole) const // maps (side, hole) to an index into m_slots
+{
+    if (hole < 0 || hole > m_holes) // hole number invalid
+        return -1;
+    return DynamicLayout(m_holes).slot(s, hole);
+}
+
+int Board::potSlot(Side s) const // index of the indicated side's pot
+{
+    return DynamicLayout(m_holes).pot(s);
+}
+
+int Board::nSlots() const // number of holes and pots
+{
+    return 2 * m_holes + 2;
+}
+
+void Board::allocate(int nHoles) // set up storage for nHoles holes per side
+{
+    m_holes = nHoles;
+    if (nSlots() <= INLINE_SLOTS)
+        m_slots = m_inline;
+    else
+        m_slots = new int[nSlots()];
+}
+
+void Board::release() // free heap storage, if any
+{
+    if (m_slots != m_inline)
+        delete [] m_slots;
+    m_slots = m_inline;
 }
@@ -1,14 +1,36 @@
 #ifndef Board_h
 #define Board_h
 #include "Side.h" 
+#include <cstdint>
 
 class Board {
 public:
+    struct Undo
+    {
+        // Everything unmakeMove needs to take back a move made by makeMove.
+        Side m_side; // side that moved
+        int m_hole; // hole the beans were sown from
+        int m_sown; // number of beans sown
+        Side m_endSide; // where the last bean landed
+        int m_endHole;
+        int m_captured; // beans captured from the opponent's hole opposite m_endHole, or 0 if none
+        bool extraTurn() const { return m_endSide == m_side && m_endHole == POT; }
+            // Return true if the last bean landed in the mover's pot, so the mover goes again.
+    };
     Board(int nHoles, int nInitialBeansPerHole);
         // Construct a Board with the indicated number of holes per side (not counting the pot) and
         // initial number of beans per hole. If nHoles is not positive, act as if it were 1; if
         // nInitialBeansPerHole is negative, act as if it were 0.
+    Board(int nHoles, const int slotBeans[]);
+        // Construct a Board with the indicated number of holes per side (which must be positive)
+        // whose holes and pots hold the numbers of beans in slotBeans, given in the order of the
+        // slot array (see BoardLayout.h): SOUTH's holes 1..nHoles, SOUTH's pot, NORTH's holes
+        // nHoles..1, NORTH's pot. A negative number of beans is taken as 0.
     Board(const Board &obj); // copy constructor
+    Board(Board &&obj); // move constructor
+    Board& operator=(const Board &rhs); // assignment operator
+    Board& operator=(Board &&rhs); // move assignment operator
+    ~Board(); // destructor
     int holes() const;
         // Return the number of holes on a side (not counting the pot).
     int beans(Side s, int hole) const;
@@ -19,6 +41,9 @@ public:
         // beans in the pot.
     int totalBeans() const;
         // Return the total number of beans in the game, including any in the pots.
+    std::uint64_t hash() const;
+        // Return a hash of the position (the number of beans in every hole and pot). Equal positions
+        // on boards with the same number of holes have equal hashes.
     bool sow(Side s, int hole, Side& endSide, int& endHole);
         // If the hole indicated by (s,hole) is empty or invalid or a pot, this function returns false
         // without changing anything. Otherwise, it will return true after sowing the beans: the beans
@@ -27,6 +52,10 @@ public:
         // hole where the last bean was placed. (This function does not make captures or multiple
         // turns; different Kalah variants have different rules about these issues, so dealing with
         // them should not be the responsibility of the Board class.)
+    bool landing(Side s, int hole, Side& endSide, int& endHole) const;
+        // If the hole indicated by (s,hole) is empty or invalid or a pot, return false. Otherwise,
+        // set endSide and endHole to where the last bean would be placed if the hole were sown, and
+        // return true. Nothing is changed.
     bool moveToPot(Side s, int hole, Side potOwner);
         // If the indicated hole is invalid or a pot, return false without changing anything.
         // Otherwise, move all the beans in hole (s,hole) into the pot belonging to potOwner and
@@ -39,19 +68,39 @@ public:
         // that we and you can more easily test your program: None of your code that implements the
         // member functions of any class is allowed to call this function directly or indirectly.
         // (We'll show an example of its use below.)
+    bool makeMove(Side s, int hole, Undo& undo);
+        // If the hole indicated by (s,hole) is empty or invalid or a pot, this function returns false
+        // without changing anything. Otherwise, it sows the beans as sow does and then, if the last
+        // bean landed in an empty hole of s's and the opponent's hole directly opposite is not
+        // empty, moves that bean and the opponent's beans into s's pot (a capture). It fills in undo
+        // so that the move can be taken back and returns true. (Extra turns and the end-of-game
+        // sweep are left to the caller; undo.extraTurn() tells whether s moves again.)
+    void unmakeMove(const Undo& undo);
+        // Restore the board exactly as it was before the makeMove call that filled in undo. Moves
+        // must be unmade in the reverse of the order in which they were made.
 private:
-    struct Node
-    {
-        int m_beans;
-        Side m_side;
-        int m_holeNum;
-        Node* m_next;
-        Node* m_prev;
-    };
-    Node* m_head;
-    int m_items; // number of items in the list
+    // The holes and pots are stored in one array in counterclockwise (sowing) order, as described
+    // in BoardLayout.h, so sowing from a slot just walks up the array, wrapping around at the end.
+    // Boards with at most INLINE_SLOTS slots (15 holes per side) keep the array inside the Board
+    // itself, so copying one never touches the heap; only bigger boards allocate.
+    static const int INLINE_SLOTS = 32;
+    int m_inline[INLINE_SLOTS];
+    int* m_slots; // points to m_inline or to a heap array of nSlots() ints
     int m_holes; // holes per side
-    void insertNode(Node* p, const int& beans, const Side& side, const int& holeNum);
+    int m_inPlay[NSIDES]; // beans in each side's holes, kept up to date by every change to m_slots
+    int m_total; // beans on the whole board, including the pots
+    std::uint64_t m_hash; // Zobrist hash of m_slots (see BoardLayout.h)
+    int nSlots() const;
+        // Return the number of holes and pots on the board.
+    void allocate(int nHoles);
+        // Point m_slots at storage for a board with nHoles holes per side (m_slots must not own
+        // any heap storage when this is called).
+    void release();
+        // Free m_slots if it is on the heap.
+    int slot(Side s, int hole) const;
+        // Return the array index of the indicated hole or pot, or -1 if the hole number is invalid.
+    int potSlot(Side s) const;
+        // Return the array index of the indicated side's pot.
 };
 
 #endif /* Board_h */
@@ -0,0 +1,289 @@
+#include "BoardBatch.h"
+#include "Side.h"
+#include "BoardLayout.h"
+#if defined(__SSE4_1__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// The move kernel below is written once against a set of vector operations on 32-bit lanes. Each
+// set has the same interface; masks are lanes of all ones (true) or all zeros (false).
+
+struct ScalarOps
+{
+    typedef int V;
+    static const int WIDTH = 1;
+    static V load(const int* p) { return *p; }
+    static void store(int* p, V v) { *p = v; }
+    static V set1(int x) { return x; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V divide(V a, int d, float) { return a / d; }
+    static V cmpeq(V a, V b) { return a == b ? -1 : 0; }
+    static V cmpgt(V a, V b) { return a > b ? -1 : 0; }
+    static V bitAnd(V a, V b) { return a & b; }
+    static V andNot(V mask, V b) { return ~mask & b; }
+    static V blend(V mask, V a, V b) { return (mask & a) | (~mask & b); } // mask ? a : b
+};
+
+#if defined(__SSE4_1__)
+struct Sse41Ops
+{
+    typedef __m128i V;
+    static const int WIDTH = 4;
+    static V load(const int* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(int* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V set1(int x) { return _mm_set1_epi32(x); }
+    static V add(V a, V b) { return _mm_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm_mullo_epi32(a, b); }
+    static V divide(V a, int, float inv) // approximate; the caller corrects it by one if needed
+        { return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(a), _mm_set1_ps(inv))); }
+    static V cmpeq(V a, V b) { return _mm_cmpeq_epi32(a, b); }
+    static V cmpgt(V a, V b) { return _mm_cmpgt_epi32(a, b); }
+    static V bitAnd(V a, V b) { return _mm_and_si128(a, b); }
+    static V andNot(V mask, V b) { return _mm_andnot_si128(mask, b); }
+    static V blend(V mask, V a, V b) { return _mm_blendv_epi8(b, a, mask); }
+};
+#endif
+
+#if defined(__AVX2__)
+struct Avx2Ops
+{
+    typedef __m256i V;
+    static const int WIDTH = 8;
+    static V load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(int* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static V set1(int x) { return _mm256_set1_epi32(x); }
+    static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm256_mullo_epi32(a, b); }
+    static V divide(V a, int, float inv) // approximate; the caller corrects it by one if needed
+        { return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(a), _mm256_set1_ps(inv))); }
+    static V cmpeq(V a, V b) { return _mm256_cmpeq_epi32(a, b); }
+    static V cmpgt(V a, V b) { return _mm256_cmpgt_epi32(a, b); }
+    static V bitAnd(V a, V b) { return _mm256_and_si256(a, b); }
+    static V andNot(V mask, V b) { return _mm256_andnot_si256(mask, b); }
+    static V blend(V mask, V a, V b) { return _mm256_blendv_epi8(b, a, mask); }
+};
+typedef Avx2Ops BatchOps;
+#elif defined(__SSE4_1__)
+typedef Sse41Ops BatchOps;
+#else
+typedef ScalarOps BatchOps;
+#endif
+
+// Widest vector any BatchOps uses; the batch is padded to a multiple of it so the kernel never
+// needs a scalar tail loop.
+const int MAX_WIDTH = 8;
+
+struct MovePlan
+{
+    // What a move from (s, hole) looks like on every board, worked out once per makeMove call.
+    DynamicLayout m_lay;
+    Side m_side;
+    int m_start; // slot sown from
+    int m_skip; // opponent's pot
+    int m_skipDist; // distance from m_start to m_skip, counted as in spreadSlots
+    int m_cycle; // slots on the sowing path
+    std::vector<int> m_pos; // position of each slot on the sowing path (see spreadSlots)
+    MovePlan(int nHoles, Side s, int hole)
+    : m_lay(nHoles), m_side(s)
+    {
+        m_start = m_lay.slot(s, hole);
+        m_skip = m_lay.pot(opponent(s));
+        m_skipDist = m_skip - m_start;
+        if (m_skipDist < 0)
+            m_skipDist += m_lay.slots();
+        m_cycle = m_lay.slots() - 1;
+        m_pos.resize(m_lay.slots());
+        for (int k = 0; k < m_lay.slots(); k++)
+        {
+            int pos = k - m_start;
+            if (pos <= 0)
+                pos += m_lay.slots();
+            if (pos > m_skipDist)
+                pos--;
+            m_pos[k] = pos;
+        }
+    }
+};
+
+template <class Ops>
+void moveKernel(const MovePlan& plan, int* beans, int stride, int* end, int* captured)
+// Make the planned move on every board (lane) of the batch; this is spreadSlots and captureSlots
+// from BoardLayout.h, with every per-board branch turned into a mask.
+{
+    typedef typename Ops::V V;
+    const DynamicLayout& lay = plan.m_lay;
+    const int nSlots = lay.slots();
+    const V zero = Ops::set1(0);
+    const V one = Ops::set1(1);
+    const V cycle = Ops::set1(plan.m_cycle);
+    const float invCycle = 1.0f / plan.m_cycle;
+    int* start = beans + plan.m_start * stride;
+    for (int i = 0; i < stride; i += Ops::WIDTH)
+    {
+        // pick up the beans; a board with none sows nothing (laps and rem are 0)
+        V sown = Ops::load(start + i);
+        Ops::store(start + i, zero);
+        V laps = Ops::divide(sown, plan.m_cycle, invCycle);
+        V rem = Ops::sub(sown, Ops::mul(laps, cycle));
+        V under = Ops::cmpgt(zero, rem); // the float division can be one off either way
+        laps = Ops::add(laps, under);
+        rem = Ops::add(rem, Ops::bitAnd(under, cycle));
+        V over = Ops::cmpgt(rem, Ops::set1(plan.m_cycle - 1));
+        laps = Ops::sub(laps, over);
+        rem = Ops::sub(rem, Ops::bitAnd(over, cycle));
+        // every slot on the path gets a bean per lap, and the first rem of them one more
+        for (int k = 0; k < nSlots; k++)
+        {
+            if (k == plan.m_skip)
+                continue;
+            int* p = beans + k * stride + i;
+            V extra = Ops::cmpgt(rem, Ops::set1(plan.m_pos[k] - 1)); // all ones if pos <= rem
+            Ops::store(p, Ops::sub(Ops::add(Ops::load(p), laps), extra));
+        }
+        // the last bean lands at position rem (or at start, if the beans made whole laps)
+        V dist = Ops::blend(Ops::cmpeq(rem, zero), cycle, rem);
+        dist = Ops::sub(dist, Ops::cmpgt(dist, Ops::set1(plan.m_skipDist - 1)));
+        V e = Ops::add(dist, Ops::set1(plan.m_start));
+        e = Ops::sub(e, Ops::bitAnd(Ops::cmpgt(e, Ops::set1(nSlots - 1)), Ops::set1(nSlots)));
+        e = Ops::blend(Ops::cmpgt(sown, zero), e, Ops::set1(-1));
+        Ops::store(end + i, e);
+        // capture: the last bean landed in an empty hole of the mover's, opposite a non-empty one
+        int* pot = beans + lay.pot(plan.m_side) * stride + i;
+        V potBeans = Ops::load(pot);
+        V took = zero;
+        for (int h = 1; h <= lay.holes(); h++)
+        {
+            int own = lay.slot(plan.m_side, h);
+            int* ownP = beans + own * stride + i;
+            int* oppP = beans + lay.slot(opponent(plan.m_side), h) * stride + i;
+            V ownBeans = Ops::load(ownP);
+            V oppBeans = Ops::load(oppP);
+            V cap = Ops::bitAnd(Ops::cmpeq(e, Ops::set1(own)),
+                                Ops::bitAnd(Ops::cmpeq(ownBeans, one), Ops::cmpgt(oppBeans, zero)));
+            potBeans = Ops::add(potBeans, Ops::bitAnd(cap, Ops::add(oppBeans, one)));
+            took = Ops::add(took, Ops::bitAnd(cap, oppBeans));
+            Ops::store(ownP, Ops::andNot(cap, ownBeans));
+            Ops::store(oppP, Ops::andNot(cap, oppBeans));
+        }
+        Ops::store(pot, potBeans);
+        Ops::store(captured + i, took);
+    }
+}
+
+} // namespace
+
+BoardBatch::BoardBatch(int nHoles, int nBoards)
+// Construct a batch of nBoards boards with the indicated number of holes per side and no
+// beans. If nHoles is not positive, act as if it were 1; if nBoards is negative, act as if
+// it were 0.
+{
+    if (nHoles < 1) // if nHoles is not pos
+        nHoles = 1;
+    if (nBoards < 0) // if nBoards is neg
+        nBoards = 0;
+    m_holes = nHoles;
+    m_size = nBoards;
+    m_stride = (nBoards + MAX_WIDTH - 1) / MAX_WIDTH * MAX_WIDTH;
+    m_beans.assign((2 * nHoles + 2) * m_stride, 0);
+    m_end.assign(m_stride, -1);
+    m_captured.assign(m_stride, 0);
+}
+
+int BoardBatch::holes() const
+// Return the number of holes on a side (not counting the pot).
+{
+    return m_holes;
+}
+
+int BoardBatch::size() const
+// Return the number of boards in the batch.
+{
+    return m_size;
+}
+
+bool BoardBatch::setBoard(int i, const Board& b)
+// If i is not a valid board number or b doesn't have holes() holes per side, return false
+// without changing anything. Otherwise, set board i to the position of b and return true.
+{
+    if (i < 0 || i >= m_size || b.holes() != m_holes)
+        return false;
+    DynamicLayout lay(m_holes);
+    for (int k = 0; k < lay.slots(); k++)
+        m_beans[k * m_stride + i] = b.beans(lay.sideOf(k), lay.holeOf(k));
+    return true;
+}
+
+Board BoardBatch::board(int i) const
+// Return a Board with the position of board i, which must be valid.
+{
+    DynamicLayout lay(m_holes);
+    std::vector<int> slots(lay.slots());
+    for (int k = 0; k < lay.slots(); k++)
+        slots[k] = m_beans[k * m_stride + i];
+    return Board(m_holes, slots.data());
+}
+
+int BoardBatch::beans(int i, Side s, int hole) const
+// Return the number of beans in the indicated hole or pot of board i, or −1 if i or the hole
+// number is invalid.
+{
+    int k = slot(s, hole);
+    if (i < 0 || i >= m_size || k == -1)
+        return -1;
+    return m_beans[k * m_stride + i];
+}
+
+void BoardBatch::makeMove(Side s, int hole)
+// On every board whose hole (s,hole) is not empty, do what Board::makeMove(s, hole, ...)
+// does: sow the beans from that hole and make any capture. Boards on which that hole is
+// empty, and every board if the hole is invalid or a pot, are left unchanged.
+{
+    if (slot(s, hole) == -1 || hole == POT) // nothing can move
+    {
+        m_end.assign(m_stride, -1);
+        m_captured.assign(m_stride, 0);
+        return;
+    }
+    MovePlan plan(m_holes, s, hole);
+    moveKernel<BatchOps>(plan, m_beans.data(), m_stride, m_end.data(), m_captured.data());
+}
+
+bool BoardBatch::moved(int i) const
+// Return true if the last call to makeMove changed board i.
+{
+    return m_end[i] != -1;
+}
+
+Side BoardBatch::endSide(int i) const
+// If the last call to makeMove changed board i, return the side where the last bean was placed.
+{
+    return DynamicLayout(m_holes).sideOf(m_end[i]);
+}
+
+int BoardBatch::endHole(int i) const
+// If the last call to makeMove changed board i, return the hole where the last bean was placed.
+{
+    return DynamicLayout(m_holes).holeOf(m_end[i]);
+}
+
+int BoardBatch::captured(int i) const
+// Return the number of the opponent's beans captured on board i by the last call to
+// makeMove, or 0 if there was no capture.
+{
+    return m_captured[i];
+}
+
+//////////
+
+int BoardBatch::slot(Side s, int hole) const // maps (side, hole) to a slot, or -1 if invalid
+{
+    if (hole < 0 || hole > m_holes) // hole number invalid
+        return -1;
+    return DynamicLayout(m_holes).slot(s, hole);
+}
@@ -0,0 +1,60 @@
+#ifndef BoardBatch_h
+#define BoardBatch_h
+#include "Side.h"
+#include "Board.h"
+#include <vector>
+
+//==========================================================================
+// A BoardBatch holds many independent positions with the same number of holes, stored as a
+// structure of arrays: one array per hole/pot (in the slot order of BoardLayout.h), holding that
+// hole's beans for every board in the batch. makeMove applies the same move to every board at
+// once, several boards per instruction when the compiler targets SSE4.1 or AVX2 (e.g. with
+// -msse4.1, -mavx2 or -march=native), or one board at a time otherwise. The results are exactly
+// those of Board::makeMove on each board, which doBatchTests in Main.cpp checks; build it with
+// -msse4.1 and with -mavx2 as well as without (see report.txt) to test every kernel.
+//==========================================================================
+
+class BoardBatch {
+public:
+    BoardBatch(int nHoles, int nBoards);
+        // Construct a batch of nBoards boards with the indicated number of holes per side and no
+        // beans. If nHoles is not positive, act as if it were 1; if nBoards is negative, act as if
+        // it were 0.
+    int holes() const;
+        // Return the number of holes on a side (not counting the pot).
+    int size() const;
+        // Return the number of boards in the batch.
+    bool setBoard(int i, const Board& b);
+        // If i is not a valid board number or b doesn't have holes() holes per side, return false
+        // without changing anything. Otherwise, set board i to the position of b and return true.
+    Board board(int i) const;
+        // Return a Board with the position of board i, which must be valid.
+    int beans(int i, Side s, int hole) const;
+        // Return the number of beans in the indicated hole or pot of board i, or −1 if i or the hole
+        // number is invalid.
+    void makeMove(Side s, int hole);
+        // On every board whose hole (s,hole) is not empty, do what Board::makeMove(s, hole, ...)
+        // does: sow the beans from that hole and make any capture. Boards on which that hole is
+        // empty, and every board if the hole is invalid or a pot, are left unchanged. The outcome
+        // on each board can be found with the functions below.
+    bool moved(int i) const;
+        // Return true if the last call to makeMove changed board i.
+    Side endSide(int i) const;
+    int endHole(int i) const;
+        // If the last call to makeMove changed board i, return the side and hole where the last
+        // bean was placed (before any capture).
+    int captured(int i) const;
+        // Return the number of the opponent's beans captured on board i by the last call to
+        // makeMove, or 0 if there was no capture.
+private:
+    int m_holes; // holes per side
+    int m_size; // boards in the batch
+    int m_stride; // m_size rounded up to a whole number of vectors
+    std::vector<int> m_beans; // m_beans[k * m_stride + i] is slot k of board i
+    std::vector<int> m_end; // slot the last bean of the last move landed in, or -1 if no move
+    std::vector<int> m_captured; // beans captured by the last move
+    int slot(Side s, int hole) const;
+        // Return the slot of the indicated hole or pot, or -1 if the hole number is invalid.
+};
+
+#endif /* BoardBatch_h */
@@ -0,0 +1,264 @@
+#ifndef BoardLayout_h
+#define BoardLayout_h
+#include "Side.h"
+#include <cstdint>
+
+//==========================================================================
+// The slot array shared by Board and BoardT<N>: the holes and pots of a board with n holes per
+// side are stored in counterclockwise (sowing) order,
+//   [0, n)           SOUTH holes 1..n
+//   n                SOUTH pot
+//   [n + 1, 2n]      NORTH holes n..1
+//   2n + 1           NORTH pot
+// A layout maps between (side, hole) and slot index. DynamicLayout works it out from a number of
+// holes known only at run time; FixedLayout<N> reads it from tables built at compile time. The
+// sowing functions below are written once against either kind of layout, so when they are used
+// with a FixedLayout every loop bound and index computation is a compile-time constant. They also
+// keep a Zobrist hash of the position up to date: the XOR of zobristKey(k, beans in slot k) over
+// every slot k, so changing one slot changes the hash by two XORs.
+//==========================================================================
+
+const int ZOBRIST_SLOTS = 34; // keys are tabulated for boards of up to 16 holes per side...
+const int ZOBRIST_BEANS = 64; // ...and up to 63 beans in a slot
+
+constexpr std::uint64_t splitMix64(std::uint64_t x)
+// A fast, well-mixed 64-bit hash of x.
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+struct ZobristTable
+{
+    std::uint64_t m_keys[ZOBRIST_SLOTS][ZOBRIST_BEANS];
+    std::uint64_t m_northToMove; // for searches that hash the side to move in too
+};
+
+constexpr ZobristTable makeZobristTable()
+{
+    ZobristTable t{};
+    for (int k = 0; k < ZOBRIST_SLOTS; k++)
+        for (int b = 0; b < ZOBRIST_BEANS; b++)
+            t.m_keys[k][b] = splitMix64(static_cast<std::uint64_t>(k) << 32 | b);
+    t.m_northToMove = splitMix64(~0ULL);
+    return t;
+}
+
+inline constexpr ZobristTable ZOBRIST = makeZobristTable();
+
+inline std::uint64_t zobristKey(int k, int beans)
+// Return the key for slot k holding the indicated number of beans.
+{
+    if (k < ZOBRIST_SLOTS && beans < ZOBRIST_BEANS)
+        return ZOBRIST.m_keys[k][beans];
+    return splitMix64(static_cast<std::uint64_t>(k) << 32 | static_cast<std::uint32_t>(beans));
+}
+
+inline std::uint64_t sizeKey(int nHoles)
+// Return a key to hash in with a position so that boards of different sizes don't share hashes.
+{
+    return splitMix64(0x4B414C4100000000ULL + nHoles);
+}
+
+template <class B>
+std::uint64_t positionKey(const B& b, Side toMove)
+// Return a hash of position b (a Board or BoardT) with toMove to move, for tables of positions
+// that may hold boards of several sizes.
+{
+    return b.hash() ^ sizeKey(b.holes()) ^ (toMove == NORTH ? ZOBRIST.m_northToMove : 0);
+}
+
+template <class Layout>
+std::uint64_t hashSlots(const Layout& lay, const int* slots)
+// Return the Zobrist hash of slots, computed from scratch.
+{
+    std::uint64_t hash = 0;
+    for (int k = 0; k < lay.slots(); k++)
+        hash ^= zobristKey(k, slots[k]);
+    return hash;
+}
+
+class DynamicLayout
+{
+public:
+    constexpr explicit DynamicLayout(int nHoles) : m_holes(nHoles) {}
+    constexpr int holes() const { return m_holes; }
+    constexpr int slots() const { return 2 * m_holes + 2; }
+    constexpr int slot(Side s, int hole) const
+        // hole must be valid (0..holes())
+        { return s == SOUTH ? (hole == POT ? m_holes : hole - 1) : 2 * m_holes + 1 - hole; }
+    constexpr int pot(Side s) const { return s == SOUTH ? m_holes : 2 * m_holes + 1; }
+    constexpr Side sideOf(int k) const { return k <= m_holes ? SOUTH : NORTH; }
+    constexpr int holeOf(int k) const { return k < m_holes ? k + 1 : (k == m_holes ? POT : 2 * m_holes + 1 - k); }
+    constexpr bool isHole(int k) const { return k != m_holes && k != 2 * m_holes + 1; }
+private:
+    int m_holes;
+};
+
+template <int N>
+struct FixedLayoutTables
+{
+    int m_slot[NSIDES][N + 1]; // slot index of (side, hole)
+    Side m_side[2 * N + 2]; // side and hole number of each slot
+    int m_hole[2 * N + 2];
+};
+
+template <int N>
+constexpr FixedLayoutTables<N> makeFixedLayoutTables()
+{
+    FixedLayoutTables<N> t{};
+    DynamicLayout lay(N);
+    for (int k = 0; k < lay.slots(); k++)
+    {
+        t.m_side[k] = lay.sideOf(k);
+        t.m_hole[k] = lay.holeOf(k);
+        t.m_slot[t.m_side[k]][t.m_hole[k]] = k;
+    }
+    return t;
+}
+
+template <int N>
+class FixedLayout
+{
+public:
+    static constexpr int holes() { return N; }
+    static constexpr int slots() { return 2 * N + 2; }
+    static constexpr int slot(Side s, int hole) { return TABLES.m_slot[s][hole]; }
+    static constexpr int pot(Side s) { return TABLES.m_slot[s][POT]; }
+    static constexpr Side sideOf(int k) { return TABLES.m_side[k]; }
+    static constexpr int holeOf(int k) { return TABLES.m_hole[k]; }
+    static constexpr bool isHole(int k) { return TABLES.m_hole[k] != POT; }
+private:
+    static constexpr FixedLayoutTables<N> TABLES = makeFixedLayoutTables<N>();
+};
+
+template <class Layout>
+int landingSlot(const Layout& lay, Side s, int start, int beans)
+// Return the slot the last of beans beans sown by s from slot start lands in.
+{
+    const int nSlots = lay.slots();
+    const int cycle = nSlots - 1;
+    int skipDist = lay.pot(opponent(s)) - start; // see spreadSlots
+    if (skipDist < 0)
+        skipDist += nSlots;
+    // the last bean lands at position beans % cycle (or at start, if the beans made whole laps)
+    int dist = beans % cycle;
+    if (dist == 0)
+        dist = cycle;
+    if (dist >= skipDist) // step over the opponent's pot
+        dist++;
+    int end = start + dist;
+    if (end >= nSlots)
+        end -= nSlots;
+    return end;
+}
+
+template <class Layout>
+int spreadSlots(const Layout& lay, int* slots, int* inPlay, std::uint64_t& hash, Side s, int start,
+                int beans, int sign)
+// Add (sign = 1) or take back (sign = -1) one bean per slot along the path a sowing of beans beans
+// by s from slot start takes, and return the slot the last bean lands in. The path visits every
+// slot but s's opponent's pot in counterclockwise order starting after start, and start itself
+// comes last, so it's a cycle of slots() - 1 slots. Rather than walk it one bean at a time, every
+// slot on it gets beans / cycle beans for the full laps, and the first beans % cycle slots get one
+// more, so the cost depends on the size of the board and not on the number of beans.
+{
+    const int nSlots = lay.slots();
+    const int cycle = nSlots - 1;
+    const int laps = beans / cycle;
+    const int rem = beans % cycle;
+    const int skip = lay.pot(opponent(s)); // opponent's pot is never sown into
+    int skipDist = skip - start; // how far along the path (counting the skipped pot) skip is
+    if (skipDist < 0)
+        skipDist += nSlots;
+    for (int k = 0; k < nSlots; k++)
+    {
+        if (k == skip)
+            continue;
+        // position of slot k on the path: 1 for the slot after start, ..., cycle for start
+        int pos = k - start;
+        if (pos <= 0)
+            pos += nSlots;
+        if (pos > skipDist)
+            pos--;
+        int add = sign * (laps + (pos <= rem ? 1 : 0));
+        hash ^= zobristKey(k, slots[k]) ^ zobristKey(k, slots[k] + add);
+        slots[k] += add;
+        if (lay.isHole(k))
+            inPlay[lay.sideOf(k)] += add;
+    }
+    return landingSlot(lay, s, start, beans);
+}
+
+template <class Layout>
+int sowSlots(const Layout& lay, int* slots, int* inPlay, std::uint64_t& hash, Side s, int start)
+// Sow the beans in slot start, which must be a non-empty hole of s's: remove them and drop one
+// in each following slot, wrapping around at the end of the array and skipping s's opponent's
+// pot. inPlay (indexed by Side) and hash are updated to match. Return the slot the last bean
+// landed in.
+{
+    int beansToSow = slots[start];
+    hash ^= zobristKey(start, beansToSow) ^ zobristKey(start, 0);
+    slots[start] = 0;
+    inPlay[s] -= beansToSow;
+    return spreadSlots(lay, slots, inPlay, hash, s, start, beansToSow, 1);
+}
+
+template <class Layout>
+void unsowSlots(const Layout& lay, int* slots, int* inPlay, std::uint64_t& hash, Side s, int start,
+                int beans)
+// Take back a sowing of beans beans by s from slot start, which has to be the last change made
+// to slots.
+{
+    spreadSlots(lay, slots, inPlay, hash, s, start, beans, -1);
+    // the beans go back into the hole they came from
+    hash ^= zobristKey(start, slots[start]) ^ zobristKey(start, slots[start] + beans);
+    slots[start] += beans;
+    inPlay[s] += beans;
+}
+
+template <class Layout>
+int captureSlots(const Layout& lay, int* slots, int* inPlay, std::uint64_t& hash, Side s, int endSlot)
+// If a sowing by s that ended in slot endSlot earns a capture (the last bean landed in an empty
+// hole of s's and the opponent's hole directly opposite is not empty), move that bean and the
+// opponent's beans into s's pot. Return the number of the opponent's beans captured, or 0 if
+// there was no capture.
+{
+    if (lay.sideOf(endSlot) != s || !lay.isHole(endSlot) || slots[endSlot] != 1)
+        return 0;
+    int opposite = lay.slot(opponent(s), lay.holeOf(endSlot));
+    int captured = slots[opposite];
+    if (captured == 0)
+        return 0;
+    int pot = lay.pot(s);
+    hash ^= zobristKey(pot, slots[pot]) ^ zobristKey(pot, slots[pot] + captured + 1)
+          ^ zobristKey(endSlot, 1) ^ zobristKey(endSlot, 0)
+          ^ zobristKey(opposite, captured) ^ zobristKey(opposite, 0);
+    slots[pot] += captured + 1;
+    slots[endSlot] = 0;
+    slots[opposite] = 0;
+    inPlay[s]--;
+    inPlay[opponent(s)] -= captured;
+    return captured;
+}
+
+template <class Layout>
+void uncaptureSlots(const Layout& lay, int* slots, int* inPlay, std::uint64_t& hash, Side s,
+                    int endSlot, int captured)
+// Take back a capture of captured beans that captureSlots made.
+{
+    int opposite = lay.slot(opponent(s), lay.holeOf(endSlot));
+    int pot = lay.pot(s);
+    hash ^= zobristKey(pot, slots[pot]) ^ zobristKey(pot, slots[pot] - captured - 1)
+          ^ zobristKey(endSlot, 0) ^ zobristKey(endSlot, 1)
+          ^ zobristKey(opposite, 0) ^ zobristKey(opposite, captured);
+    slots[pot] -= captured + 1;
+    slots[endSlot] = 1;
+    slots[opposite] = captured;
+    inPlay[s]++;
+    inPlay[opponent(s)] += captured;
+}
+
+#endif /* BoardLayout_h */
@@ -0,0 +1,181 @@
+#ifndef BoardT_h
+#define BoardT_h
+#include "Side.h"
+#include "Board.h"
+#include "BoardLayout.h"
+
+//==========================================================================
+// BoardT<N> is a Board whose number of holes per side is fixed at compile time. It has the same
+// interface and rules as Board, but its slot array is a plain member of exactly 2N + 2 ints and
+// all of its layout arithmetic comes from FixedLayout<N>, so the compiler can resolve every index
+// and unroll every loop over the holes. Code that is written against the Board interface (like
+// SmartPlayer's search) can be instantiated with either kind of board; withBoard below picks the
+// right one for a Board of a given size.
+//==========================================================================
+
+template <int N>
+class BoardT {
+public:
+    typedef Board::Undo Undo;
+    explicit BoardT(int nInitialBeansPerHole);
+        // Construct a BoardT with N holes per side, each with the indicated initial number of beans
+        // (act as if it were 0 if it is negative).
+    explicit BoardT(const Board& b);
+        // Construct a BoardT with the same position as b, which must have N holes per side.
+    static constexpr int holes() { return N; }
+        // Return the number of holes on a side (not counting the pot).
+    int beans(Side s, int hole) const;
+        // Return the number of beans in the indicated hole or pot, or −1 if the hole number is
+        // invalid.
+    int beansInPlay(Side s) const { return m_inPlay[s]; }
+        // Return the total number of beans in all the holes on the indicated side, not counting the
+        // beans in the pot.
+    int totalBeans() const { return m_total; }
+        // Return the total number of beans in the game, including any in the pots.
+    std::uint64_t hash() const { return m_hash; }
+        // Same as Board::hash (a BoardT and a Board with the same position have the same hash).
+    bool sow(Side s, int hole, Side& endSide, int& endHole);
+        // Same as Board::sow.
+    bool landing(Side s, int hole, Side& endSide, int& endHole) const;
+        // Same as Board::landing.
+    bool moveToPot(Side s, int hole, Side potOwner);
+        // Same as Board::moveToPot.
+    bool setBeans(Side s, int hole, int beans);
+        // Same as Board::setBeans.
+    bool makeMove(Side s, int hole, Undo& undo);
+        // Same as Board::makeMove.
+    void unmakeMove(const Undo& undo);
+        // Same as Board::unmakeMove.
+private:
+    typedef FixedLayout<N> Layout;
+    static bool validHole(int hole) { return hole >= 0 && hole <= N; }
+    int m_slots[Layout::slots()]; // see BoardLayout.h
+    int m_inPlay[NSIDES]; // beans in each side's holes
+    int m_total; // beans on the whole board, including the pots
+    std::uint64_t m_hash; // Zobrist hash of m_slots
+};
+
+template <class F>
+void withBoard(const Board& b, F f)
+// Call f with a mutable copy of b: a BoardT<N> for the sizes production uses (4, 6 and 8 holes),
+// or a Board for any other size. f must accept either type, e.g. a generic lambda.
+{
+    switch (b.holes())
+    {
+        case 4: { BoardT<4> copy(b); f(copy); break; }
+        case 6: { BoardT<6> copy(b); f(copy); break; }
+        case 8: { BoardT<8> copy(b); f(copy); break; }
+        default: { Board copy(b); f(copy); break; }
+    }
+}
+
+//////////
+
+template <int N>
+BoardT<N>::BoardT(int nInitialBeansPerHole)
+{
+    if (nInitialBeansPerHole < 0) // if nInitialBeansPerHole is neg
+        nInitialBeansPerHole = 0;
+    for (int k = 0; k < Layout::slots(); k++)
+        m_slots[k] = Layout::isHole(k) ? nInitialBeansPerHole : 0;
+    m_inPlay[SOUTH] = m_inPlay[NORTH] = N * nInitialBeansPerHole;
+    m_total = 2 * N * nInitialBeansPerHole;
+    m_hash = hashSlots(Layout(), m_slots);
+}
+
+template <int N>
+BoardT<N>::BoardT(const Board& b)
+{
+    m_inPlay[SOUTH] = b.beansInPlay(SOUTH);
+    m_inPlay[NORTH] = b.beansInPlay(NORTH);
+    m_total = b.totalBeans();
+    for (int k = 0; k < Layout::slots(); k++)
+        m_slots[k] = b.beans(Layout::sideOf(k), Layout::holeOf(k));
+    m_hash = b.hash();
+}
+
+template <int N>
+int BoardT<N>::beans(Side s, int hole) const
+{
+    if (!validHole(hole)) // hole/pot number invalid
+        return -1;
+    return m_slots[Layout::slot(s, hole)];
+}
+
+template <int N>
+bool BoardT<N>::sow(Side s, int hole, Side& endSide, int& endHole)
+{
+    if (!validHole(hole) || hole == POT || m_slots[Layout::slot(s, hole)] == 0) // empty/invalid/pot
+        return false;
+    int k = sowSlots(Layout(), m_slots, m_inPlay, m_hash, s, Layout::slot(s, hole));
+    endSide = Layout::sideOf(k);
+    endHole = Layout::holeOf(k);
+    return true;
+}
+
+template <int N>
+bool BoardT<N>::landing(Side s, int hole, Side& endSide, int& endHole) const
+{
+    if (!validHole(hole) || hole == POT || m_slots[Layout::slot(s, hole)] == 0) // empty/invalid/pot
+        return false;
+    int k = landingSlot(Layout(), s, Layout::slot(s, hole), m_slots[Layout::slot(s, hole)]);
+    endSide = Layout::sideOf(k);
+    endHole = Layout::holeOf(k);
+    return true;
+}
+
+template <int N>
+bool BoardT<N>::moveToPot(Side s, int hole, Side potOwner)
+{
+    if (!validHole(hole) || hole == POT) // hole invalid or a pot
+        return false;
+    int k = Layout::slot(s, hole);
+    int pot = Layout::pot(potOwner);
+    m_hash ^= zobristKey(pot, m_slots[pot]) ^ zobristKey(pot, m_slots[pot] + m_slots[k])
+            ^ zobristKey(k, m_slots[k]) ^ zobristKey(k, 0);
+    m_slots[pot] += m_slots[k]; // move all beans in hole to the pot
+    m_inPlay[s] -= m_slots[k];
+    m_slots[k] = 0;
+    return true;
+}
+
+template <int N>
+bool BoardT<N>::setBeans(Side s, int hole, int beans)
+{
+    if (beans < 0 || !validHole(hole)) // beans is neg or indicated hole is invalid
+        return false;
+    int k = Layout::slot(s, hole);
+    if (hole != POT)
+        m_inPlay[s] += beans - m_slots[k];
+    m_total += beans - m_slots[k];
+    m_hash ^= zobristKey(k, m_slots[k]) ^ zobristKey(k, beans);
+    m_slots[k] = beans;
+    return true;
+}
+
+template <int N>
+bool BoardT<N>::makeMove(Side s, int hole, Undo& undo)
+{
+    if (!validHole(hole) || hole == POT || m_slots[Layout::slot(s, hole)] == 0) // empty/invalid/pot
+        return false;
+    undo.m_side = s;
+    undo.m_hole = hole;
+    undo.m_sown = m_slots[Layout::slot(s, hole)];
+    int k = sowSlots(Layout(), m_slots, m_inPlay, m_hash, s, Layout::slot(s, hole));
+    undo.m_endSide = Layout::sideOf(k);
+    undo.m_endHole = Layout::holeOf(k);
+    undo.m_captured = captureSlots(Layout(), m_slots, m_inPlay, m_hash, s, k);
+    return true;
+}
+
+template <int N>
+void BoardT<N>::unmakeMove(const Undo& undo)
+{
+    Side s = undo.m_side;
+    if (undo.m_captured > 0) // put the captured beans back where they came from
+        uncaptureSlots(Layout(), m_slots, m_inPlay, m_hash, s, Layout::slot(undo.m_endSide, undo.m_endHole),
+                       undo.m_captured);
+    unsowSlots(Layout(), m_slots, m_inPlay, m_hash, s, Layout::slot(s, undo.m_hole), undo.m_sown);
+}
+
+#endif /* BoardT_h */
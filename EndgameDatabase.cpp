@@ -0,0 +1,265 @@
+#include "EndgameDatabase.h"
+#include "Board.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// A database file is this header followed by the margins, one signed byte each.
+struct FileHeader
+{
+    char m_magic[8];
+    std::uint32_t m_version;
+    std::uint32_t m_holes;
+    std::uint32_t m_maxBeans;
+    std::uint32_t m_reserved;
+    std::uint64_t m_entries;
+};
+
+const char MAGIC[8] = { 'K', 'A', 'L', 'A', 'H', 'E', 'G', 'D' };
+const std::uint32_t VERSION = 1;
+const int MAX_HOLES = 16;
+const int MAX_BEANS = 127; // so every margin fits in a signed byte
+const std::uint64_t MAX_POSITIONS = std::uint64_t(1) << 31; // most positions generate will solve
+
+} // namespace
+
+EndgameDatabase::EndgameDatabase()
+// Construct an EndgameDatabase with no positions in it.
+: m_holes(0), m_maxBeans(-1), m_data(nullptr), m_mapping(nullptr), m_mappingSize(0)
+{
+}
+
+EndgameDatabase::~EndgameDatabase()
+{
+    close();
+}
+
+bool EndgameDatabase::open(const std::string& path)
+// Memory-map the database in the indicated file, closing any that was open. Return false
+// (leaving no database open) if the file can't be opened or isn't a database.
+{
+    close();
+    std::size_t size = 0;
+    void* mapping = nullptr;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(sizeof(FileHeader)))
+    {
+        HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (map != nullptr)
+        {
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+            mapping = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0); // the view keeps map alive
+            CloseHandle(map);
+        }
+    }
+    CloseHandle(file);
+    if (mapping == nullptr)
+        return false;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(FileHeader)))
+    {
+        size = static_cast<std::size_t>(st.st_size);
+        mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            mapping = nullptr;
+    }
+    ::close(fd); // the mapping stays valid
+    if (mapping == nullptr)
+        return false;
+#endif
+    m_mapping = mapping;
+    m_mappingSize = size;
+    // check that it's a database, and that its size matches what its header says is in it
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.m_magic, MAGIC, sizeof(MAGIC)) != 0 || header.m_version != VERSION
+        || header.m_holes < 1 || header.m_holes > MAX_HOLES || header.m_maxBeans > MAX_BEANS)
+    {
+        close();
+        return false;
+    }
+    setShape(header.m_holes, header.m_maxBeans);
+    std::uint64_t entries = 2 * positions(m_maxBeans);
+    if (positions(m_maxBeans) > MAX_POSITIONS || header.m_entries != entries
+        || size - sizeof(FileHeader) != entries)
+    {
+        close();
+        return false;
+    }
+    m_data = static_cast<const std::int8_t*>(mapping) + sizeof(FileHeader);
+    return true;
+}
+
+void EndgameDatabase::close()
+// Unmap the open database, if any.
+{
+    if (m_mapping != nullptr)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_mapping);
+#else
+        munmap(m_mapping, m_mappingSize);
+#endif
+    }
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_data = nullptr;
+    m_holes = 0;
+    m_maxBeans = -1;
+    m_choose.clear();
+}
+
+bool EndgameDatabase::generate(int nHoles, int maxBeans, const std::string& path, std::ostream* progress)
+// Solve every position with nHoles holes per side (1 to 16) and at most maxBeans beans in
+// the holes (0 to 127) and write the database to the indicated file, reporting progress to
+// *progress if it isn't null. Return false if the arguments are out of range or the file
+// can't be written.
+{
+    if (nHoles < 1 || nHoles > MAX_HOLES || maxBeans < 0 || maxBeans > MAX_BEANS)
+        return false;
+    EndgameDatabase db;
+    db.setShape(nHoles, maxBeans);
+    if (db.positions(maxBeans) > MAX_POSITIONS) // too big to solve in memory
+        return false;
+    const int m = 2 * nHoles;
+    const std::int8_t UNSOLVED = std::numeric_limits<std::int8_t>::min(); // no margin is this low
+    std::vector<std::int8_t> margins(2 * db.positions(maxBeans), UNSOLVED);
+    Board board(nHoles, 0);
+    std::vector<int> holeBeans(m);
+    std::vector<int> slots(m + 2, 0); // holeBeans in slot order, with empty pots
+
+    // put the rank'th of the positions with beans beans in the holes into holeBeans (the
+    // reverse of index)
+    auto unrank = [&](int beans, std::uint64_t rank) {
+        int left = beans;
+        for (int i = 0; i < m - 1; i++)
+        {
+            int p = m - 1 - i;
+            int v = 0;
+            while (v < left && db.choose(left + p, p) - db.choose(left - (v + 1) + p, p) <= rank)
+                v++;
+            rank -= db.choose(left + p, p) - db.choose(left - v + p, p);
+            holeBeans[i] = v;
+            left -= v;
+        }
+        holeBeans[m - 1] = left;
+    };
+
+    // margin of the position on board (with empty pots) with s to move, given that every
+    // position it can move to has been solved
+    auto solve = [&](Side s) {
+        if (board.beansInPlay(SOUTH) == 0 || board.beansInPlay(NORTH) == 0) // game over
+            return board.beansInPlay(SOUTH) - board.beansInPlay(NORTH);
+        int best = (s == SOUTH ? -MAX_BEANS - 1 : MAX_BEANS + 1);
+        for (int hole = 1; hole <= nHoles; hole++)
+        {
+            Board::Undo undo;
+            if (!board.makeMove(s, hole, undo))
+                continue;
+            Side next = undo.extraTurn() ? s : opponent(s);
+            int v = board.beans(SOUTH, POT) - board.beans(NORTH, POT);
+            if (board.beansInPlay(SOUTH) == 0 || board.beansInPlay(NORTH) == 0) // the move ends the game
+                v += board.beansInPlay(SOUTH) - board.beansInPlay(NORTH);
+            else
+                v += margins[db.index(board, next)];
+            board.unmakeMove(undo);
+            if (s == SOUTH ? v > best : v < best)
+                best = v;
+        }
+        return best;
+    };
+
+    for (int beans = 0; beans <= maxBeans; beans++)
+    {
+        // A move either puts at least one bean in a pot, leaving fewer beans in the holes, or (if
+        // it doesn't reach a pot) moves beans closer to the mover's pot. So if positions are solved
+        // in order of the number of beans in the holes, and then of the total distance of the
+        // beans from the pots they're heading for, every move leads to a game over or to a
+        // position already solved.
+        std::uint64_t first = (beans > 0 ? db.positions(beans - 1) : 0);
+        std::uint64_t n = db.positions(beans) - first;
+        std::vector<std::uint16_t> distance(n);
+        std::vector<std::uint64_t> count(beans * nHoles + 2, 0);
+        for (std::uint64_t r = 0; r < n; r++)
+        {
+            unrank(beans, r);
+            int d = 0;
+            for (int i = 0; i < m; i++) // SOUTH sows toward hole N, NORTH toward hole 1
+                d += holeBeans[i] * (i < nHoles ? nHoles - i : i - nHoles + 1);
+            distance[r] = d;
+            count[d + 1]++;
+        }
+        for (std::size_t d = 1; d < count.size(); d++) // count[d]: positions closer than d
+            count[d] += count[d - 1];
+        std::vector<std::uint32_t> order(n);
+        for (std::uint64_t r = 0; r < n; r++)
+            order[count[distance[r]]++] = static_cast<std::uint32_t>(r);
+        for (std::uint64_t i = 0; i < n; i++)
+        {
+            unrank(beans, order[i]);
+            for (int h = 0; h < nHoles; h++) // SOUTH's holes go up the array, NORTH's back down
+            {
+                slots[h] = holeBeans[h];
+                slots[m - h] = holeBeans[nHoles + h];
+            }
+            board = Board(nHoles, slots.data());
+            margins[db.index(board, NORTH)] = solve(NORTH);
+            margins[db.index(board, SOUTH)] = solve(SOUTH);
+        }
+        if (progress != nullptr)
+            *progress << "solved " << n << " positions with " << beans << " beans in the holes" << std::endl;
+    }
+
+    FileHeader header;
+    std::memcpy(header.m_magic, MAGIC, sizeof(MAGIC));
+    header.m_version = VERSION;
+    header.m_holes = nHoles;
+    header.m_maxBeans = maxBeans;
+    header.m_reserved = 0;
+    header.m_entries = margins.size();
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(margins.data()), margins.size());
+    return static_cast<bool>(out.flush());
+}
+
+//////////
+
+void EndgameDatabase::setShape(int nHoles, int maxBeans)
+{
+    m_holes = nHoles;
+    m_maxBeans = maxBeans;
+    // Pascal's triangle, rows 0 to maxBeans + 2 * nHoles; entries too big for 64 bits stay at the
+    // maximum, which is more than any database can have
+    int m = 2 * nHoles;
+    int rows = maxBeans + m + 1;
+    m_choose.assign(rows * (m + 1), 0);
+    for (int t = 0; t < rows; t++)
+    {
+        m_choose[t * (m + 1)] = 1;
+        for (int p = 1; p <= m && p <= t; p++)
+        {
+            std::uint64_t a = m_choose[(t - 1) * (m + 1) + p - 1], b = m_choose[(t - 1) * (m + 1) + p];
+            m_choose[t * (m + 1) + p] = (a + b < a ? std::numeric_limits<std::uint64_t>::max() : a + b);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef EndgameDatabase_h
+#define EndgameDatabase_h
+#include "Side.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//==========================================================================
+// An EndgameDatabase holds the perfect-play result of every position, for one number of holes per
+// side, that has at most a given number of beans left in the holes. How the rest of a game goes
+// depends only on the beans in the holes and whose turn it is (the pots just add a constant), so
+// each entry is the margin: the number of the remaining beans SOUTH will end up with minus the
+// number NORTH will, if both play to maximize their own. The margin plus the current difference
+// between the pots decides the game, so a search that reaches a position in the database knows its
+// exact value without looking further.
+//
+// generate solves every position by retrograde analysis and writes the database to a file (see
+// tools/makeendgame.cpp); open memory-maps such a file, so nothing is read until a probe touches
+// it. Positions are numbered by ranking the way their beans are spread over the 2N holes, so a
+// probe is one array access after a pass over the holes.
+//==========================================================================
+
+class EndgameDatabase
+{
+public:
+    EndgameDatabase();
+        // Construct an EndgameDatabase with no positions in it.
+    ~EndgameDatabase();
+    EndgameDatabase(const EndgameDatabase&) = delete;
+    EndgameDatabase& operator=(const EndgameDatabase&) = delete;
+    bool open(const std::string& path);
+        // Memory-map the database in the indicated file, closing any that was open. Return false
+        // (leaving no database open) if the file can't be opened or isn't a database.
+    void close();
+        // Unmap the open database, if any.
+    bool isOpen() const { return m_data != nullptr; }
+        // Return true if a database is open.
+    int holes() const { return m_holes; }
+        // Return the number of holes per side of the positions in the open database.
+    int maxBeans() const { return m_maxBeans; }
+        // Return the most beans in the holes of any position in the open database.
+    template <class B>
+    bool probe(const B& b, Side s, int& margin) const;
+        // If the open database has position b (a Board or BoardT) with s to move, set margin to the
+        // beans SOUTH will win from the holes minus the beans NORTH will, with perfect play, and
+        // return true. Otherwise, return false.
+    static bool generate(int nHoles, int maxBeans, const std::string& path,
+                         std::ostream* progress = nullptr);
+        // Solve every position with nHoles holes per side (1 to 16) and at most maxBeans beans in
+        // the holes (0 to 127) and write the database to the indicated file, reporting progress to
+        // *progress if it isn't null. Return false if the arguments are out of range or the file
+        // can't be written.
+private:
+    int m_holes;
+    int m_maxBeans;
+    std::vector<std::uint64_t> m_choose; // m_choose[t * (2 * m_holes + 1) + p] is t choose p
+    const std::int8_t* m_data; // margins, two per position (NORTH to move, then SOUTH)
+    void* m_mapping; // the mapped file
+    std::size_t m_mappingSize;
+    void setShape(int nHoles, int maxBeans);
+        // Set the shape of positions to nHoles holes and at most maxBeans beans, and fill m_choose.
+    std::uint64_t choose(int t, int p) const { return m_choose[t * (2 * m_holes + 1) + p]; }
+    std::uint64_t positions(int beans) const { return choose(beans + 2 * m_holes, 2 * m_holes); }
+        // Return the number of positions with at most the indicated number of beans in the holes.
+    template <class B>
+    std::uint64_t index(const B& b, Side s) const;
+        // Return the index in m_data of position b with s to move.
+};
+
+//////////
+
+template <class B>
+bool EndgameDatabase::probe(const B& b, Side s, int& margin) const
+{
+    if (m_data == nullptr || b.holes() != m_holes
+        || b.beansInPlay(SOUTH) + b.beansInPlay(NORTH) > m_maxBeans)
+        return false;
+    margin = m_data[index(b, s)];
+    return true;
+}
+
+template <class B>
+std::uint64_t EndgameDatabase::index(const B& b, Side s) const
+{
+    // The holes are taken in the order SOUTH 1..N, NORTH 1..N. Positions are numbered first by the
+    // total number of beans in the holes, then in lexicographic order of the number in each hole;
+    // the positions that come before this one are those with fewer beans in total, plus, for each
+    // hole, those that agree with it on every earlier hole and have fewer beans in this one.
+    int m = 2 * m_holes;
+    int left = b.beansInPlay(SOUTH) + b.beansInPlay(NORTH);
+    std::uint64_t rank = (left > 0 ? positions(left - 1) : 0);
+    for (int i = 0; i < m - 1; i++)
+    {
+        int v = (i < m_holes ? b.beans(SOUTH, i + 1) : b.beans(NORTH, i - m_holes + 1));
+        int p = m - 1 - i; // holes after this one
+        rank += choose(left + p, p) - choose(left - v + p, p);
+        left -= v;
+    }
+    return 2 * rank + s;
+}
+
+#endif /* EndgameDatabase_h */
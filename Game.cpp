@@ -14,34 +14,22 @@ Game::Game(const Board& b, Player* south, Player* north)
     m_south = south;
     m_north = north;
     m_turn = SOUTH;
+    m_observer = nullptr;
+    m_console.setPlayers(*south, *north);
+    m_recordWriter = nullptr;
 }
 
 void Game::display() const
 // Display the game's board in a manner of your choosing, provided you show the names of the
 // players and a reasonable representation of the state of the board.
 {
-    cout << "-----" << endl;
+    cout << "-----" << '\n';
     if (m_turn == NORTH)
-        cout << m_north->name() << "'s move:" << endl << endl;
+        cout << m_north->name() << "'s move:" << '\n' << '\n';
     else
-        cout << m_south->name() << "'s move:" << endl << endl;
-    cout << '\t' << '\t' << '\t' << m_north->name() << endl;
-    // display the north holes
-    cout << '\t' << '\t';
-    for (int i = 0; i < m_board.holes(); i++)
-        cout << beans(NORTH, i + 1) << '\t';
-    cout << endl;
-    // display the pots
-    cout << '\t' << beans(NORTH, 0);
-    for (int i = 0; i < m_board.holes(); i++)
-        cout << '\t';
-    cout << '\t' << beans(SOUTH, 0) << endl;
-    // display the south holes
-    cout << '\t' << '\t';
-    for (int i = 0; i < m_board.holes(); i++)
-        cout << beans(SOUTH, i + 1) << '\t';
-    cout << endl;
-    cout << '\t' << '\t' << '\t' << m_south->name() << endl;
+        cout << m_south->name() << "'s move:" << '\n' << '\n';
+    ConsoleObserver::drawBoard(cout, m_board, m_south->name(), m_north->name());
+    cout.flush();
 }
 
 void Game::status(bool& over, bool& hasWinner, Side& winner) const
@@ -51,18 +39,20 @@ void Game::status(bool& over, bool& hasWinner, Side& winner) const
 // otherwise, set it to the winning side.
 {
     // Game Over: all of the holes on one side of the board empty
-    if (m_board.beansInPlay(NORTH) == 0 || m_board.beansInPlay(SOUTH) == 0)
+    int northInPlay = m_board.beansInPlay(NORTH);
+    int southInPlay = m_board.beansInPlay(SOUTH);
+    if (northInPlay == 0 || southInPlay == 0)
     {
         over = true;
         // check for a winner (the player with the most beans in their pot)
-        if ((m_board.beansInPlay(NORTH) + m_board.beans(NORTH, 0)) ==
-            (m_board.beansInPlay(SOUTH) + m_board.beans(SOUTH, 0))) // tie
+        int northTotal = northInPlay + m_board.beans(NORTH, 0);
+        int southTotal = southInPlay + m_board.beans(SOUTH, 0);
+        if (northTotal == southTotal) // tie
             hasWinner = false;
         else // there's a winner
         {
             hasWinner = true;
-            if ((m_board.beansInPlay(NORTH) + m_board.beans(NORTH, 0)) >
-                (m_board.beansInPlay(SOUTH) + m_board.beans(SOUTH, 0))) // north wins
+            if (northTotal > southTotal) // north wins
                 winner = NORTH;
             else // south wins
                 winner = SOUTH;
@@ -83,51 +73,147 @@ bool Game::move()
     status(over, hasWinner, winner);
     if (over == true) // game is over
     {
-        // game is over
-        // sweep any beans in the holes to the pots
-        cout << endl;
-        for (int i = 0; i < m_board.holes(); i++)
-        {
-            m_board.moveToPot(NORTH, i + 1, NORTH);
-            m_board.moveToPot(SOUTH, i + 1, SOUTH);
-        }
-        display(); cout << endl;
+        sweep();
         return false;
     }
-    int hole; Side endSide; int endHole;
-    if (m_turn == NORTH) // north player's turn
-        hole = m_north->chooseMove(m_board, NORTH);
-    else // south player's turn
-        hole = m_south->chooseMove(m_board, SOUTH);
-    m_board.sow(m_turn, hole, endSide, endHole);
-    // If it was placed in the player's pot, he must take another turn if the game isn't over
+    // the player keeps sowing until their turn (or the game) is over
+    Side mover = m_turn;
+    Player* player = (m_turn == NORTH ? m_north : m_south);
+    while (sowing(player->chooseMove(m_board, m_turn)))
+        ;
+    return m_turn != mover; // false if the game ended before the turn did
+}
+
+void Game::play()
+// Play the game. Display the progress of the game in a manner of your choosing, provided that
+// someone looking at the screen can follow what's happening. If neither player is
+// interactive, then to keep the display from quickly scrolling through the whole game, it
+// would be reasonable periodically to prompt the viewer to press ENTER to continue and not
+// proceed until ENTER is pressed. (The ignore function for input streams is useful here.)
+// Announce the winner at the end of the game. You can apportion to your liking the
+// responsibility for displaying the board between this function and the move function. (Note:
+// If when this function is called, South has no beans in play, so can't make the first move,
+// sweep any beans on the North side into North's pot and act as if the game is thus over.)
+{
+    bool GameOver; bool hasWinner; Side winner = SOUTH; // winner is only set if there is one
+    observer().gameStarted(m_board, *m_south, *m_north);
+    status(GameOver, hasWinner, winner);
+    if (GameOver)
+        sweep();
+    while (!GameOver) // while the game isn't over
+    {
+        observer().turnStarting(m_board, m_turn);
+        if (move()) // player makes move
+            observer().turnEnded(m_board, m_turn);
+        status(GameOver, hasWinner, winner); // check game status after move
+    }
+    observer().gameOver(m_board, hasWinner, winner);
+}
+
+int Game::beans(Side s, int hole) const
+// Return the number of beans in the indicated hole or pot of the game's board, or −1 if the
+// hole number is invalid. This function exists so that we and you can more easily test your
+// program.
+{
+    return m_board.beans(s, hole);
+}
+
+void Game::setObserver(GameObserver* observer)
+// Tell observer about everything that happens in the game from now on (see GameObserver.h); if
+// observer is null, go back to showing the game on the console, which is what a Game does to
+// begin with. The Game doesn't take ownership of observer.
+{
+    m_observer = observer;
+}
+
+void Game::setRecordWriter(GameRecordWriter* writer)
+// Record the game from now on (call this before the first move) and, as soon as it's over,
+// write the record with writer (see GameRecord.h); if writer is null, stop recording. The
+// Game doesn't take ownership of writer.
+{
+    m_recordWriter = writer;
+    m_record.m_start = m_board;
+    m_record.m_southName = m_south->name();
+    m_record.m_northName = m_north->name();
+    m_record.m_sowings.clear();
+}
+
+bool Game::begin()
+// Start playing the game one sowing at a time with takeSowing, for a caller that gets the
+// players' moves itself rather than having play or move ask for them: tell the observer the
+// game is starting and return true if South can move. If South can't, finish the game as play
+// does and return false.
+{
+    bool over, hasWinner; Side winner = SOUTH; // winner is only set if there is one
+    observer().gameStarted(m_board, *m_south, *m_north);
     status(over, hasWinner, winner);
-    while (endSide == m_turn && endHole == 0)
+    if (over)
+    {
+        sweep();
+        observer().gameOver(m_board, hasWinner, winner);
+        return false;
+    }
+    observer().turnStarting(m_board, m_turn);
+    return true;
+}
+
+bool Game::takeSowing(int hole)
+// Sow the beans from the indicated hole, which must be a legal move, for the player whose
+// turn it is, and do whatever follows as move does, telling the observer everything play
+// would. Return true if the game goes on, with turn() to sow next; return false if it's over.
+{
+    Side mover = m_turn;
+    if (sowing(hole))
+        return true;
+    if (m_turn != mover)
+        observer().turnEnded(m_board, m_turn);
+    bool over, hasWinner; Side winner = SOUTH; // winner is only set if there is one
+    status(over, hasWinner, winner);
+    if (over)
+    {
+        observer().gameOver(m_board, hasWinner, winner);
+        return false;
+    }
+    if (m_turn != mover)
+        observer().turnStarting(m_board, m_turn);
+    return true;
+}
+
+//////////
+
+GameObserver& Game::observer()
+{
+    return m_observer != nullptr ? *m_observer : m_console;
+}
+
+void Game::sweep()
+{
+    // sweep any beans in the holes to the pots
+    for (int i = 0; i < m_board.holes(); i++)
+    {
+        m_board.moveToPot(NORTH, i + 1, NORTH);
+        m_board.moveToPot(SOUTH, i + 1, SOUTH);
+    }
+    observer().swept(m_board);
+    finish();
+}
+
+bool Game::sowing(int hole)
+{
+    bool over; bool hasWinner; Side winner;
+    Side endSide; int endHole;
+    sow(hole, endSide, endHole);
+    // If it was placed in the player's pot, he must take another turn if the game isn't over
+    if (endSide == m_turn && endHole == 0)
     {
         status(over, hasWinner, winner);
-        if (!over)
-        {
-            display();
-            cout << endl;
-            if (m_turn == NORTH) // north player's turn
-                hole = m_north->chooseMove(m_board, NORTH);
-            else // south player's turn
-                hole = m_south->chooseMove(m_board, SOUTH);
-            m_board.sow(m_turn, hole, endSide, endHole);
-        }
-        else
+        if (over)
         {
-            // game is over
-            // sweep any beans in the holes to the pots
-            cout << endl;
-            for (int i = 0; i < m_board.holes(); i++)
-            {
-                m_board.moveToPot(NORTH, i + 1, NORTH);
-                m_board.moveToPot(SOUTH, i + 1, SOUTH);
-            }
-            display(); cout << endl;
+            sweep();
             return false;
         }
+        observer().extraTurn(m_board, m_turn);
+        return true;
     }
     // If capture occurred
     // placed in one of the player's own holes that was empty just a moment before
@@ -136,89 +222,45 @@ bool Game::move()
         && m_board.beans(opponent(m_turn), endHole) > 0)
     {
         // that bean and all beans in the opponent's hole directly opposite from that hole are put into the players pot
+        int captured = 1 + m_board.beans(opponent(m_turn), endHole);
         m_board.moveToPot(m_turn, endHole, m_turn);
         m_board.moveToPot(opponent(m_turn), endHole, m_turn);
+        observer().captured(m_board, m_turn, endHole, captured);
         status(over, hasWinner, winner);
         if (over)
         {
-            // game is over
-            // sweep any beans in the holes to the pots
-            cout << endl;
-            for (int i = 0; i < m_board.holes(); i++)
-            {
-                m_board.moveToPot(NORTH, i + 1, NORTH);
-                m_board.moveToPot(SOUTH, i + 1, SOUTH);
-            }
-            display(); cout << endl;
+            sweep();
             return false;
         }
     }
     // Turn ends
     m_turn = opponent(m_turn);
-    return true;
+    status(over, hasWinner, winner);
+    if (over) // nobody will be asked for another move
+        finish();
+    return false;
 }
 
-void Game::play()
-// Play the game. Display the progress of the game in a manner of your choosing, provided that
-// someone looking at the screen can follow what's happening. If neither player is
-// interactive, then to keep the display from quickly scrolling through the whole game, it
-// would be reasonable periodically to prompt the viewer to press ENTER to continue and not
-// proceed until ENTER is pressed. (The ignore function for input streams is useful here.)
-// Announce the winner at the end of the game. You can apportion to your liking the
-// responsibility for displaying the board between this function and the move function. (Note:
-// If when this function is called, South has no beans in play, so can't make the first move,
-// sweep any beans on the North side into North's pot and act as if the game is thus over.)
+void Game::sow(int hole, Side& endSide, int& endHole)
 {
-    bool GameOver; bool hasWinner; Side winner;
-    display(); cout << endl;
-    status(GameOver, hasWinner, winner);
-    if (GameOver)
-    {
-        // sweep beans
-        cout << endl;
-        for (int i = 0; i < m_board.holes(); i++)
-        {
-            m_board.moveToPot(NORTH, i + 1, NORTH);
-            m_board.moveToPot(SOUTH, i + 1, SOUTH);
-        }
-        display(); cout << endl;
-    }
-    while (!GameOver) // while the game isn't over
-    {
-        if (!m_north->isInteractive() && !m_south->isInteractive()) // neither interactive
-        {
-            // prompt the viewer to press ENTER to continue and not proceed until ENTER is pressed
-            cout << "Press enter to continue." << endl;
-            cin.ignore(10000,'\n');
-        }
-        move(); // player makes move
-        display();
-        cout << endl;
-        status(GameOver, hasWinner, winner); // check game status after move
-    }
-    // check for tie
-    if (hasWinner == false)
-    {
-        cout << "-----" << endl;
-        cout << "Tie." << endl;
-    }
-    else
+    m_board.sow(m_turn, hole, endSide, endHole);
+    if (m_recordWriter != nullptr)
+        m_record.m_sowings.push_back(static_cast<std::uint8_t>(hole));
+    observer().moved(m_board, m_turn, hole);
+}
+
+void Game::finish()
+{
+    stopPondering();
+    if (m_recordWriter != nullptr)
     {
-    // announce the winner
-        cout << "-----" << endl;
-        cout << "The winner is ";
-        if (winner == SOUTH)
-            cout << m_south->name();
-        else
-            cout << m_north->name();
-        cout << endl;
+        m_recordWriter->write(m_record);
+        m_recordWriter = nullptr; // the game is recorded only once
     }
 }
 
-int Game::beans(Side s, int hole) const
-// Return the number of beans in the indicated hole or pot of the game's board, or −1 if the
-// hole number is invalid. This function exists so that we and you can more easily test your
-// program.
+void Game::stopPondering()
 {
-    return m_board.beans(s, hole);
+    m_south->stopPondering();
+    m_north->stopPondering();
 }
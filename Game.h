@@ -2,6 +2,8 @@
 #define Game_h
 #include "Board.h"
 #include "Side.h"
+#include "GameObserver.h"
+#include "GameRecord.h"
 class Player;
 
 class Game {
@@ -37,11 +39,53 @@ public:
         // Return the number of beans in the indicated hole or pot of the game's board, or −1 if the
         // hole number is invalid. This function exists so that we and you can more easily test your
         // program.
+    void setObserver(GameObserver* observer);
+        // Tell observer about everything that happens in the game from now on (see GameObserver.h); if
+        // observer is null, go back to showing the game on the console, which is what a Game does to
+        // begin with. The Game doesn't take ownership of observer.
+    void setRecordWriter(GameRecordWriter* writer);
+        // Record the game from now on (call this before the first move) and, as soon as it's over,
+        // write the record with writer (see GameRecord.h); if writer is null, stop recording. The
+        // Game doesn't take ownership of writer.
+    bool begin();
+        // Start playing the game one sowing at a time with takeSowing, for a caller that gets the
+        // players' moves itself (see GameHost.h) rather than having play or move ask for them: tell
+        // the observer the game is starting and return true if South can move. If South can't,
+        // finish the game as play does and return false.
+    bool takeSowing(int hole);
+        // Sow the beans from the indicated hole, which must be a legal move, for the player whose
+        // turn it is, and do whatever follows as move does (a capture, the end of the turn, the end
+        // of the game), telling the observer everything play would. Return true if the game goes
+        // on, with turn() to sow next (the same player again if their last bean landed in their
+        // pot); return false if it's over.
+    Side turn() const { return m_turn; }
+        // Return the side whose turn it is.
+    const Board& board() const { return m_board; }
+        // Return the game's board.
 private:
+    GameObserver& observer();
+        // Return the observer to tell about the game's events.
+    void sow(int hole, Side& endSide, int& endHole);
+        // Sow the beans from the indicated hole of the player whose turn it is, record the sowing
+        // if the game is being recorded, and tell the observer.
+    bool sowing(int hole);
+        // Sow the beans from the indicated hole for the player whose turn it is and carry out the
+        // rules. Return true if the same player must sow again; otherwise the turn, or the game, is
+        // over.
+    void sweep();
+        // The game is over: put the beans left in each side's holes in its pot, and finish.
+    void finish();
+        // The game is over: stop pondering and write the record, if the game is being recorded.
+    void stopPondering();
+        // Tell both players the game is over, so they stop any thinking on the opponent's time.
     Board m_board;
     Player* m_south;
     Player* m_north;
     Side m_turn;
+    GameObserver* m_observer; // where the game's events go, or null for m_console
+    ConsoleObserver m_console; // shows the game on the console
+    GameRecordWriter* m_recordWriter; // where to write the game's record, or null if not recording
+    GameRecord m_record; // the game so far, if recording
 };
 
 #endif /* Game_h */
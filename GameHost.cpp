@@ -0,0 +1,198 @@
+#include "GameHost.h"
+
+struct GameHost::Table
+{
+    // A game being hosted. Only one thing happens to a game at a time (it waits for one move, then
+    // one thread makes it and asks for the next), so the game itself needs no lock; m_busy tells
+    // cancel to wait while a thread is changing it.
+    Table(const Board& b, Player* south, Player* north)
+    : m_game(b, south, north), m_south(south), m_north(north), m_over(false), m_cancelled(false),
+      m_busy(false), m_hasWinner(false), m_winner(SOUTH), m_southBeans(0), m_northBeans(0)
+    {}
+    Game m_game;
+    Player* m_south;
+    Player* m_north;
+    std::shared_ptr<MoveRequest> m_request; // the move being waited for, or null
+    bool m_over; // finished or cancelled
+    bool m_cancelled;
+    bool m_busy; // a thread is beginning the game or making a sowing
+    bool m_hasWinner; // the result, once the game has finished
+    Side m_winner;
+    int m_southBeans;
+    int m_northBeans;
+};
+
+GameHost::GameHost(int threads)
+// Construct a GameHost that advances its games, and runs its computer players' searches,
+// on the indicated number of threads; if threads isn't positive, one per processor core.
+: m_playing(0), m_pool(threads)
+{
+}
+
+GameHost::~GameHost()
+// Cancel the games still going and wait for them to stop.
+{
+    for (size_t i = 0; i < m_tables.size(); i++)
+        cancel(static_cast<int>(i));
+    wait();
+}
+
+int GameHost::add(const Board& b, Player* south, Player* north, GameObserver* observer,
+                  GameRecordWriter* writer)
+// Start a game between the indicated players on a copy of board b, with south moving
+// first, and return its number. Tell observer about the game's events, or nobody if it's null,
+// and record the game with writer if it isn't null.
+{
+    Table* t = new Table(b, south, north);
+    t->m_game.setObserver(observer != nullptr ? observer : &m_quiet);
+    if (writer != nullptr)
+        t->m_game.setRecordWriter(writer);
+    int game;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tables.push_back(std::unique_ptr<Table>(t));
+        game = static_cast<int>(m_tables.size()) - 1;
+        m_playing++;
+    }
+    m_pool.submit([this, t]() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (t->m_over) // cancelled before it began
+                return;
+            t->m_busy = true;
+        }
+        moveMade(*t, t->m_game.begin());
+    });
+    return game;
+}
+
+void GameHost::cancel(int game)
+// Stop the indicated game where it is, if it's still going: the player whose turn it is
+// stops thinking, and the game isn't recorded or told it's over. If a sowing is being made in
+// the game, wait for it to be done first, so nothing more happens to the game once this returns.
+{
+    std::shared_ptr<MoveRequest> request;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Table* t = m_tables[game].get();
+        m_idle.wait(lock, [t]() { return !t->m_busy; });
+        if (t->m_over)
+            return;
+        request.swap(t->m_request);
+        finished(*t, true);
+    }
+    if (request != nullptr)
+    {
+        // stop the player's search, and complete the request now in case the player never does
+        // (a RemotePlayer whose person has gone away, say); whatever it completes it with later
+        // is ignored
+        request->cancel();
+        request->complete(-1);
+    }
+}
+
+bool GameHost::over(int game) const
+// Return true if the indicated game has finished or been cancelled.
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tables[game]->m_over;
+}
+
+bool GameHost::result(int game, bool& hasWinner, Side& winner, int& southBeans,
+                      int& northBeans) const
+// If the indicated game has finished (and wasn't cancelled), set hasWinner and winner as
+// Game::status does and southBeans and northBeans to the beans in each side's pot, and
+// return true; otherwise, return false and leave them unchanged.
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Table& t = *m_tables[game];
+    if (!t.m_over || t.m_cancelled)
+        return false;
+    hasWinner = t.m_hasWinner;
+    if (t.m_hasWinner)
+        winner = t.m_winner;
+    southBeans = t.m_southBeans;
+    northBeans = t.m_northBeans;
+    return true;
+}
+
+int GameHost::playing() const
+// Return the number of games still going.
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_playing;
+}
+
+void GameHost::wait()
+// Wait until every game added so far has finished or been cancelled, and its players
+// have stopped thinking.
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_allOver.wait(lock, [this]() { return m_playing == 0; });
+    }
+    // a cancelled game's player may still be finishing its search
+    m_pool.wait();
+}
+
+//////////
+
+void GameHost::moveMade(Table& t, bool goesOn)
+{
+    Player* player = (t.m_game.turn() == SOUTH ? t.m_south : t.m_north);
+    // the move may be completed on any thread (a RemotePlayer's comes from whoever submits it), so
+    // the game goes on from there on one of the pool's threads
+    std::shared_ptr<MoveRequest> request = std::make_shared<MoveRequest>([this, &t](int hole) {
+        m_pool.submit([this, &t, hole]() { moveChosen(t, hole); });
+    });
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (goesOn)
+            t.m_request = request;
+        else
+            finished(t, false);
+        t.m_busy = false;
+    }
+    m_idle.notify_all();
+    // nothing changes the game until the move arrives, so the player can look at it while a
+    // cancel goes on
+    if (goesOn)
+        player->chooseMoveAsync(t.m_game.board(), t.m_game.turn(), m_pool, request);
+}
+
+void GameHost::moveChosen(Table& t, int hole)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (t.m_over) // cancelled while the player was thinking
+            return;
+        t.m_request.reset();
+        t.m_busy = true; // a cancel now waits for the sowing to be made
+    }
+    const Board& b = t.m_game.board();
+    Side s = t.m_game.turn();
+    if (hole < 1 || hole > b.holes() || b.beans(s, hole) == 0) // not a legal move
+    {
+        // a player that doesn't get to finish thinking can come up with no move at all; take the
+        // first legal one, as a SmartPlayer does when it has no time to search
+        hole = 1;
+        while (b.beans(s, hole) == 0)
+            hole++;
+    }
+    moveMade(t, t.m_game.takeSowing(hole));
+}
+
+void GameHost::finished(Table& t, bool cancelled)
+{
+    t.m_over = true;
+    t.m_cancelled = cancelled;
+    if (!cancelled) // the game is over and nothing else will touch it
+    {
+        bool over;
+        t.m_game.status(over, t.m_hasWinner, t.m_winner);
+        t.m_southBeans = t.m_game.beans(SOUTH, POT);
+        t.m_northBeans = t.m_game.beans(NORTH, POT);
+    }
+    if (--m_playing == 0)
+        m_allOver.notify_all();
+}
@@ -0,0 +1,87 @@
+#ifndef GameHost_h
+#define GameHost_h
+#include "Board.h"
+#include "Game.h"
+#include "GameObserver.h"
+#include "GameRecord.h"
+#include "Player.h"
+#include "ThreadPool.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+//==========================================================================
+// A GameHost plays many games at once on a few threads. Game::play asks each player for its
+// moves and waits for them, so a program playing a game that way needs a thread for as long as the
+// game lasts, most of it spent waiting for a person or a search. A GameHost instead asks each
+// player with Player::chooseMoveAsync and carries on with the game (a sowing, then the next
+// request) on a thread of its ThreadPool only once the move arrives. A computer player's search
+// runs on one of the pool's threads; a person's move (from a RemotePlayer) takes no thread at all
+// until it's submitted. So the threads limit how many searches run at once, not how many games
+// are going, and thousands of games, with any mix of people and computer players, can be hosted
+// by one program.
+//
+// A game's events go to its observer (see GameObserver.h) from whichever of the pool's threads is
+// advancing it, one event at a time. Each player may take part in only one game going at a time,
+// since players keep things from one move to the next, and should search on one thread and not
+// ponder, since those would take threads of their own.
+//==========================================================================
+
+class GameHost
+{
+public:
+    explicit GameHost(int threads = 0);
+        // Construct a GameHost that advances its games, and runs its computer players' searches,
+        // on the indicated number of threads; if threads isn't positive, one per processor core.
+    ~GameHost();
+        // Cancel the games still going and wait for them to stop.
+    GameHost(const GameHost&) = delete;
+    GameHost& operator=(const GameHost&) = delete;
+    int add(const Board& b, Player* south, Player* north, GameObserver* observer = nullptr,
+            GameRecordWriter* writer = nullptr);
+        // Start a game between the indicated players on a copy of board b, with south moving
+        // first, and return its number (games are numbered from 0 in the order they're added).
+        // Tell observer about the game's events, or nobody if it's null, and record the game with
+        // writer if it isn't null. The GameHost doesn't take ownership of the players, the
+        // observer or the writer, which must last until wait has returned after the game is over
+        // (or the GameHost is destroyed).
+    void cancel(int game);
+        // Stop the indicated game where it is, if it's still going: the player whose turn it is
+        // stops thinking, and the game isn't recorded or told it's over. If a sowing is being made
+        // in the game, wait for it to be done first, so nothing more happens to the game once this
+        // returns; so it mustn't be called from the game's own observer.
+    bool over(int game) const;
+        // Return true if the indicated game has finished or been cancelled.
+    bool result(int game, bool& hasWinner, Side& winner, int& southBeans, int& northBeans) const;
+        // If the indicated game has finished (and wasn't cancelled), set hasWinner and winner as
+        // Game::status does and southBeans and northBeans to the beans in each side's pot, and
+        // return true; otherwise, return false and leave them unchanged.
+    int playing() const;
+        // Return the number of games still going.
+    void wait();
+        // Wait until every game added so far has finished or been cancelled, and its players
+        // have stopped thinking.
+    int threads() const { return m_pool.size(); }
+        // Return the number of threads the games are played on.
+private:
+    struct Table; // one game and what the host knows about it (see GameHost.cpp)
+    void moveMade(Table& t, bool goesOn);
+        // t's game has begun, or had a sowing made, and goes on if goesOn is true: ask the player
+        // whose turn it is for their move, or finish the game. Either way, the game is no longer
+        // busy.
+    void moveChosen(Table& t, int hole);
+        // Make the sowing chosen for t's game and ask for the next one, or finish the game.
+    void finished(Table& t, bool cancelled);
+        // t's game is over, or has been cancelled (m_mutex must be locked).
+    mutable std::mutex m_mutex; // guards the members below, and the Tables' m_request, m_over,
+                                // m_busy and results
+    std::condition_variable m_allOver; // signaled when m_playing becomes 0
+    std::condition_variable m_idle; // signaled when a Table's m_busy is cleared
+    std::deque<std::unique_ptr<Table> > m_tables; // every game added, by number
+    int m_playing; // games still going
+    NullObserver m_quiet; // the observer of games that weren't given one
+    ThreadPool m_pool; // last, so its threads are done with the Tables before they're destroyed
+};
+
+#endif /* GameHost_h */
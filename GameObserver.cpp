@@ -0,0 +1,134 @@
+#include "GameObserver.h"
+#include "Player.h"
+
+// A GameObserver ignores every event unless a derived class says otherwise.
+
+void GameObserver::gameStarted(const Board&, const Player&, const Player&)
+{
+}
+
+void GameObserver::turnStarting(const Board&, Side)
+{
+}
+
+void GameObserver::moved(const Board&, Side, int)
+{
+}
+
+void GameObserver::extraTurn(const Board&, Side)
+{
+}
+
+void GameObserver::captured(const Board&, Side, int, int)
+{
+}
+
+void GameObserver::turnEnded(const Board&, Side)
+{
+}
+
+void GameObserver::swept(const Board&)
+{
+}
+
+void GameObserver::gameOver(const Board&, bool, Side)
+{
+}
+
+GameObserver::~GameObserver()
+{
+}
+
+ConsoleObserver::ConsoleObserver(std::ostream& out, std::istream& in)
+// Create a ConsoleObserver that writes the game to out and, between the turns of a game
+// between two computer players, waits for ENTER to be pressed on in.
+: m_out(out), m_in(in), m_pause(false)
+{
+}
+
+void ConsoleObserver::setPlayers(const Player& south, const Player& north)
+// Use the indicated players' names when showing the board, and wait for ENTER before each
+// turn if neither is interactive.
+{
+    m_southName = south.name();
+    m_northName = north.name();
+    m_pause = !south.isInteractive() && !north.isInteractive();
+}
+
+void ConsoleObserver::drawBoard(std::ostream& out, const Board& b, const std::string& southName,
+                                const std::string& northName)
+// Write board b to out, with the players' names on their sides.
+{
+    out << '\t' << '\t' << '\t' << northName << '\n';
+    // display the north holes
+    out << '\t' << '\t';
+    for (int i = 0; i < b.holes(); i++)
+        out << b.beans(NORTH, i + 1) << '\t';
+    out << '\n';
+    // display the pots
+    out << '\t' << b.beans(NORTH, POT);
+    for (int i = 0; i < b.holes(); i++)
+        out << '\t';
+    out << '\t' << b.beans(SOUTH, POT) << '\n';
+    // display the south holes
+    out << '\t' << '\t';
+    for (int i = 0; i < b.holes(); i++)
+        out << b.beans(SOUTH, i + 1) << '\t';
+    out << '\n';
+    out << '\t' << '\t' << '\t' << southName << '\n';
+}
+
+void ConsoleObserver::gameStarted(const Board& b, const Player& south, const Player& north)
+// Show the board.
+{
+    setPlayers(south, north);
+    show(b, m_southName + "'s move:");
+}
+
+void ConsoleObserver::turnStarting(const Board&, Side)
+// If neither player is interactive, wait for ENTER so the game doesn't scroll by.
+{
+    if (!m_pause)
+        return;
+    // prompt the viewer to press ENTER to continue and not proceed until ENTER is pressed
+    m_out << "Press enter to continue." << std::endl;
+    m_in.ignore(10000, '\n');
+}
+
+void ConsoleObserver::extraTurn(const Board& b, Side s)
+// Show the board, so someone looking at the screen can follow the extra turn.
+{
+    show(b, (s == SOUTH ? m_southName : m_northName) + " moves again:");
+}
+
+void ConsoleObserver::turnEnded(const Board& b, Side next)
+// Show the board, as play did after every move.
+{
+    show(b, (next == SOUTH ? m_southName : m_northName) + "'s move:");
+}
+
+void ConsoleObserver::swept(const Board& b)
+// Show the final board.
+{
+    show(b, "Final board:");
+}
+
+void ConsoleObserver::gameOver(const Board&, bool hasWinner, Side winner)
+// Announce the winner.
+{
+    m_out << "-----" << '\n';
+    // check for tie
+    if (!hasWinner)
+        m_out << "Tie." << std::endl;
+    else // announce the winner
+        m_out << "The winner is " << (winner == SOUTH ? m_southName : m_northName) << std::endl;
+}
+
+//////////
+
+void ConsoleObserver::show(const Board& b, const std::string& heading)
+{
+    m_out << "-----" << '\n' << heading << '\n' << '\n';
+    drawBoard(m_out, b, m_southName, m_northName);
+    m_out << '\n';
+}
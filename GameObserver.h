@@ -0,0 +1,83 @@
+#ifndef GameObserver_h
+#define GameObserver_h
+#include "Board.h"
+#include "Side.h"
+#include <iostream>
+#include <string>
+class Player;
+
+//==========================================================================
+// A GameObserver is told what happens in a Game as it happens: the Game calls one of its
+// functions for each event, passing the board as it is just after the event. Every function does
+// nothing by default, so an observer overrides only the events it cares about. A Game shows its
+// progress on the console with a ConsoleObserver unless it's given another observer; a
+// NullObserver ignores everything, so games played with one (as a Tournament does) spend no time
+// at all formatting or writing output.
+//==========================================================================
+
+class GameObserver
+{
+public:
+    virtual void gameStarted(const Board& b, const Player& south, const Player& north);
+        // Game::play is starting a game between the indicated players on board b.
+    virtual void turnStarting(const Board& b, Side s);
+        // Game::play is about to have s take a turn.
+    virtual void moved(const Board& b, Side s, int hole);
+        // s has sown the beans from the indicated hole (before any capture).
+    virtual void extraTurn(const Board& b, Side s);
+        // s's last bean landed in s's pot, so s moves again.
+    virtual void captured(const Board& b, Side s, int hole, int beans);
+        // s's last bean landed in s's empty hole with the indicated number, so it and the beans
+        // opposite, beans in all, have been put in s's pot.
+    virtual void turnEnded(const Board& b, Side next);
+        // Game::play has finished a turn and it's now next's turn. A Game::move made on its own
+        // doesn't tell of this, so the board isn't shown after every move of a game played that way.
+    virtual void swept(const Board& b);
+        // The game is over, and the beans left in each side's holes have been put in its pot.
+    virtual void gameOver(const Board& b, bool hasWinner, Side winner);
+        // Game::play has finished the game. If hasWinner is false, it's a tie and winner means
+        // nothing.
+    virtual ~GameObserver();
+        // Since this class is designed as a base class, it should have a virtual destructor.
+};
+
+class NullObserver : public GameObserver
+{
+    // Ignores every event.
+};
+
+class ConsoleObserver : public GameObserver
+{
+public:
+    ConsoleObserver(std::ostream& out = std::cout, std::istream& in = std::cin);
+        // Create a ConsoleObserver that writes the game to out and, between the turns of a game
+        // between two computer players, waits for ENTER to be pressed on in.
+    void setPlayers(const Player& south, const Player& north);
+        // Use the indicated players' names when showing the board, and wait for ENTER before each
+        // turn if neither is interactive. (gameStarted does this too.)
+    static void drawBoard(std::ostream& out, const Board& b, const std::string& southName,
+                          const std::string& northName);
+        // Write board b to out, with the players' names on their sides.
+    virtual void gameStarted(const Board& b, const Player& south, const Player& north);
+        // Show the board.
+    virtual void turnStarting(const Board& b, Side s);
+        // If neither player is interactive, wait for ENTER so the game doesn't scroll by.
+    virtual void extraTurn(const Board& b, Side s);
+        // Show the board, so someone looking at the screen can follow the extra turn.
+    virtual void turnEnded(const Board& b, Side next);
+        // Show the board, as play did after every move.
+    virtual void swept(const Board& b);
+        // Show the final board.
+    virtual void gameOver(const Board& b, bool hasWinner, Side winner);
+        // Announce the winner.
+private:
+    std::ostream& m_out;
+    std::istream& m_in;
+    std::string m_southName;
+    std::string m_northName;
+    bool m_pause; // whether to wait for ENTER before each turn
+    void show(const Board& b, const std::string& heading);
+        // Write a separator, the heading and board b.
+};
+
+#endif /* GameObserver_h */
@@ -0,0 +1,332 @@
+#include "GameRecord.h"
+#include "BoardLayout.h"
+#include <cstring>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// A record file is this header followed by the records.
+struct FileHeader
+{
+    char m_magic[8];
+    std::uint32_t m_version;
+    std::uint32_t m_reserved;
+};
+
+const char MAGIC[8] = { 'K', 'A', 'L', 'A', 'H', 'R', 'E', 'C' };
+const std::uint32_t VERSION = 1;
+const int FIXED_BYTES = 12; // bytes of a record before the starting beans
+const int MAX_BYTE = 255; // most holes, name length or hole number a record can hold
+const int MAX_BEANS = 65535; // most beans a hole or pot can start with
+
+void append(std::vector<char>& out, const void* data, std::size_t n)
+// Add n bytes starting at data to the end of out.
+{
+    const char* p = static_cast<const char*>(data);
+    out.insert(out.end(), p, p + n);
+}
+
+} // namespace
+
+GameRecordWriter::GameRecordWriter(std::size_t batchBytes)
+// Construct a GameRecordWriter with no file open, that collects records until it has at
+// least batchBytes bytes of them before writing them to the file all at once.
+: m_batchBytes(batchBytes), m_records(0)
+{
+}
+
+GameRecordWriter::~GameRecordWriter()
+// Write any records not yet written and close the file.
+{
+    close();
+}
+
+bool GameRecordWriter::open(const std::string& path)
+// Close any file that was open (writing its records first) and open the record file at the
+// indicated path to add records to the end of it, creating it if it doesn't exist. Return
+// false (leaving no file open) if it can't be opened or exists but isn't a record file.
+{
+    close();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // a file that's already there must start with the header
+    std::ifstream in(path.c_str(), std::ios::binary);
+    bool exists = false;
+    if (in)
+    {
+        in.seekg(0, std::ios::end);
+        exists = (in.tellg() > 0);
+        in.seekg(0);
+        FileHeader header;
+        if (exists && (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+                       || std::memcmp(header.m_magic, MAGIC, sizeof(MAGIC)) != 0
+                       || header.m_version != VERSION))
+            return false;
+    }
+    in.close();
+    m_out.open(path.c_str(), std::ios::binary | std::ios::app);
+    if (!m_out)
+        return false;
+    if (!exists)
+    {
+        FileHeader header;
+        std::memcpy(header.m_magic, MAGIC, sizeof(MAGIC));
+        header.m_version = VERSION;
+        header.m_reserved = 0;
+        if (!m_out.write(reinterpret_cast<const char*>(&header), sizeof(header)))
+        {
+            m_out.close();
+            return false;
+        }
+    }
+    m_records = 0;
+    return true;
+}
+
+bool GameRecordWriter::write(const GameRecord& record)
+// Add record to the file. Return false (adding nothing) if no file is open or the record
+// can't be stored in the format above. Several threads may write to one writer at once.
+{
+    const Board& b = record.m_start;
+    int nHoles = b.holes();
+    if (nHoles > MAX_BYTE || record.m_southName.size() > MAX_BYTE
+        || record.m_northName.size() > MAX_BYTE)
+        return false;
+    std::uint32_t size = static_cast<std::uint32_t>(FIXED_BYTES + 2 * (2 * nHoles + 2)
+                                                    + record.m_southName.size()
+                                                    + record.m_northName.size()
+                                                    + record.m_sowings.size());
+    std::uint32_t sowings = static_cast<std::uint32_t>(record.m_sowings.size());
+    std::uint8_t sizes[4] = { static_cast<std::uint8_t>(nHoles),
+                              static_cast<std::uint8_t>(record.m_southName.size()),
+                              static_cast<std::uint8_t>(record.m_northName.size()), 0 };
+    std::vector<std::uint16_t> beans;
+    for (int i = 0; i < 2 * nHoles + 2; i++)
+    {
+        Side s = (i <= nHoles ? SOUTH : NORTH);
+        int hole = (i <= nHoles ? i + 1 : i - nHoles);
+        if (hole == nHoles + 1) // after hole N comes the pot
+            hole = POT;
+        int n = b.beans(s, hole);
+        if (n > MAX_BEANS)
+            return false;
+        beans.push_back(static_cast<std::uint16_t>(n));
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_out.is_open())
+        return false;
+    append(m_batch, &size, sizeof(size));
+    append(m_batch, &sowings, sizeof(sowings));
+    append(m_batch, sizes, sizeof(sizes));
+    append(m_batch, beans.data(), beans.size() * sizeof(std::uint16_t));
+    append(m_batch, record.m_southName.data(), record.m_southName.size());
+    append(m_batch, record.m_northName.data(), record.m_northName.size());
+    append(m_batch, record.m_sowings.data(), record.m_sowings.size());
+    m_records++;
+    if (m_batch.size() >= m_batchBytes)
+        return flushBatch();
+    return true;
+}
+
+bool GameRecordWriter::flush()
+// Write every record added so far to the file. Return false if writing failed.
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return flushBatch() && m_out.flush();
+}
+
+void GameRecordWriter::close()
+// Write any records not yet written and close the file.
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_out.is_open())
+        return;
+    flushBatch();
+    m_out.close();
+}
+
+//////////
+
+bool GameRecordWriter::flushBatch()
+{
+    bool ok = true;
+    if (!m_batch.empty())
+        ok = static_cast<bool>(m_out.write(m_batch.data(), m_batch.size()));
+    m_batch.clear();
+    return ok;
+}
+
+int GameRecordReader::Entry::startBeans(Side s, int hole) const
+// Return the number of beans in the indicated hole or pot at the start of the game.
+{
+    int i = (hole == POT ? holes() : hole - 1) + (s == NORTH ? holes() + 1 : 0);
+    std::uint16_t n;
+    std::memcpy(&n, m_data + FIXED_BYTES + 2 * i, sizeof(n));
+    return n;
+}
+
+std::string GameRecordReader::Entry::southName() const
+{
+    return std::string(reinterpret_cast<const char*>(m_data + nameOffset()), m_data[9]);
+}
+
+std::string GameRecordReader::Entry::northName() const
+// Return the players' names.
+{
+    return std::string(reinterpret_cast<const char*>(m_data + nameOffset() + m_data[9]), m_data[10]);
+}
+
+Board GameRecordReader::Entry::startBoard() const
+// Return the board the game started from.
+{
+    DynamicLayout lay(holes());
+    std::vector<int> slots(lay.slots());
+    for (int k = 0; k < lay.slots(); k++)
+        slots[k] = startBeans(lay.sideOf(k), lay.holeOf(k));
+    return Board(holes(), slots.data());
+}
+
+bool GameRecordReader::Entry::replay(Board& b) const
+// Set b to the board the game started from and make every sowing on it. Return false,
+// stopping there, if a sowing isn't a legal move.
+{
+    return replay(b, [](const Board&, Side, int) {});
+}
+
+GameRecord GameRecordReader::Entry::toRecord() const
+// Return a copy of the record.
+{
+    GameRecord r;
+    r.m_start = startBoard();
+    r.m_southName = southName();
+    r.m_northName = northName();
+    const std::uint8_t* first = m_data + nameOffset() + m_data[9] + m_data[10];
+    r.m_sowings.assign(first, first + sowings());
+    return r;
+}
+
+std::uint32_t GameRecordReader::Entry::read32(int offset) const
+{
+    std::uint32_t n;
+    std::memcpy(&n, m_data + offset, sizeof(n));
+    return n;
+}
+
+GameRecordReader::GameRecordReader()
+// Construct a GameRecordReader with no file open.
+: m_mapping(nullptr), m_mappingSize(0), m_start(0), m_offset(0), m_damaged(false)
+{
+}
+
+GameRecordReader::~GameRecordReader()
+{
+    close();
+}
+
+bool GameRecordReader::open(const std::string& path)
+// Memory-map the record file at the indicated path, closing any that was open, and get ready
+// to read its first record. Return false (leaving no file open) if the file can't be
+// opened or isn't a record file.
+{
+    close();
+    std::size_t size = 0;
+    void* mapping = nullptr;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(sizeof(FileHeader)))
+    {
+        HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (map != nullptr)
+        {
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+            mapping = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0); // the view keeps map alive
+            CloseHandle(map);
+        }
+    }
+    CloseHandle(file);
+    if (mapping == nullptr)
+        return false;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(FileHeader)))
+    {
+        size = static_cast<std::size_t>(st.st_size);
+        mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            mapping = nullptr;
+        else // the records will be read from start to end
+            madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    ::close(fd); // the mapping stays valid
+    if (mapping == nullptr)
+        return false;
+#endif
+    m_mapping = mapping;
+    m_mappingSize = size;
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.m_magic, MAGIC, sizeof(MAGIC)) != 0 || header.m_version != VERSION)
+    {
+        close();
+        return false;
+    }
+    m_start = sizeof(FileHeader);
+    rewind();
+    return true;
+}
+
+void GameRecordReader::close()
+// Unmap the open file, if any.
+{
+    if (m_mapping != nullptr)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_mapping);
+#else
+        munmap(m_mapping, m_mappingSize);
+#endif
+    }
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_start = m_offset = 0;
+    m_damaged = false;
+}
+
+bool GameRecordReader::next(Entry& entry)
+// Set entry to the next record in the file and return true, or return false if there are
+// no more (or the rest of the file isn't made of whole, well-formed records, in which case
+// damaged returns true).
+{
+    if (m_mapping == nullptr || m_offset == m_mappingSize)
+        return false;
+    const std::uint8_t* data = static_cast<const std::uint8_t*>(m_mapping) + m_offset;
+    std::size_t left = m_mappingSize - m_offset;
+    // the record's fields must add up to its size, which must fit in what's left of the file
+    Entry e;
+    e.m_data = data;
+    if (left < FIXED_BYTES || e.read32(0) > left || e.read32(0) < FIXED_BYTES
+        || e.read32(0) < static_cast<std::uint32_t>(e.nameOffset())
+        || e.read32(0) != e.nameOffset() + static_cast<std::uint64_t>(data[9]) + data[10]
+                          + e.read32(4)
+        || e.holes() == 0)
+    {
+        m_damaged = true;
+        return false;
+    }
+    m_offset += e.read32(0);
+    entry = e;
+    return true;
+}
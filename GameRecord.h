@@ -0,0 +1,168 @@
+#ifndef GameRecord_h
+#define GameRecord_h
+#include "Board.h"
+#include "Side.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//==========================================================================
+// A GameRecord is a complete game: the board it started from, the players' names, and the hole of
+// every sowing made, in order. SOUTH makes the first sowing, and each sowing is by the same side as
+// the one before it if that one's last bean landed in its own pot (and the game wasn't over), and
+// by the other side otherwise, so the holes alone are enough to replay the game.
+//
+// A GameRecordWriter appends records to a file, and a GameRecordReader memory-maps such a file and
+// goes through its records. A record file is a small header followed by the records one after
+// another, each of which is
+//
+//     4 bytes   size of the record in bytes, counting these 4
+//     4 bytes   number of sowings
+//     1 byte    holes per side, N (at most 255)
+//     1 byte    length of SOUTH's name (at most 255 bytes)
+//     1 byte    length of NORTH's name
+//     1 byte    0
+//     2N+2 x 2 bytes   beans at the start in SOUTH's holes 1..N, SOUTH's pot, NORTH's holes
+//                      1..N and NORTH's pot (each at most 65535)
+//     the names, SOUTH's then NORTH's
+//     1 byte per sowing: the hole sown
+//
+// with the numbers in the byte order of the machine that wrote them. A Game given a writer
+// (Game::setRecordWriter) records itself and writes its record when it's over.
+//==========================================================================
+
+struct GameRecord
+{
+    GameRecord() : m_start(1, 0) {}
+    Board m_start; // the board before the first sowing
+    std::string m_southName;
+    std::string m_northName;
+    std::vector<std::uint8_t> m_sowings; // the hole of each sowing, in order
+};
+
+class GameRecordWriter
+{
+public:
+    explicit GameRecordWriter(std::size_t batchBytes = 1 << 20);
+        // Construct a GameRecordWriter with no file open, that collects records until it has at
+        // least batchBytes bytes of them before writing them to the file all at once.
+    ~GameRecordWriter();
+        // Write any records not yet written and close the file.
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+    bool open(const std::string& path);
+        // Close any file that was open (writing its records first) and open the record file at the
+        // indicated path to add records to the end of it, creating it if it doesn't exist. Return
+        // false (leaving no file open) if it can't be opened or exists but isn't a record file.
+    bool write(const GameRecord& record);
+        // Add record to the file. Return false (adding nothing) if no file is open or the record
+        // can't be stored in the format above. Several threads may write to one writer at once.
+    bool flush();
+        // Write every record added so far to the file. Return false if writing failed.
+    void close();
+        // Write any records not yet written and close the file.
+    long records() const { return m_records; }
+        // Return the number of records added since the file was opened.
+private:
+    std::ofstream m_out;
+    std::vector<char> m_batch; // records added, not yet written to m_out
+    std::size_t m_batchBytes; // size m_batch reaches before it's written
+    long m_records;
+    std::mutex m_mutex; // guards the members above
+    bool flushBatch();
+        // Write m_batch to m_out and empty it (m_mutex must be locked).
+};
+
+class GameRecordReader
+{
+public:
+    class Entry
+    {
+        // One record in a mapped file. The functions read its fields where they lie in the
+        // mapping, so an Entry is only good while the GameRecordReader it came from stays open.
+    public:
+        int holes() const { return m_data[8]; }
+            // Return the number of holes per side.
+        int startBeans(Side s, int hole) const;
+            // Return the number of beans in the indicated hole or pot at the start of the game.
+        std::string southName() const;
+        std::string northName() const;
+            // Return the players' names.
+        int sowings() const { return static_cast<int>(read32(4)); }
+            // Return the number of sowings in the game.
+        int sowing(int i) const { return m_data[nameOffset() + m_data[9] + m_data[10] + i]; }
+            // Return the hole of sowing i (counting from 0).
+        Board startBoard() const;
+            // Return the board the game started from.
+        template <class F>
+        bool replay(Board& b, F visit) const;
+            // Set b to the board the game started from and make every sowing (with any capture) on
+            // it, calling visit(b, s, hole) after each one, where s is the side that sowed. Return
+            // false, stopping there, if a sowing isn't a legal move. The end-of-game sweep isn't
+            // made, so b is left as it was after the last sowing.
+        bool replay(Board& b) const;
+            // Do the same without visiting anything.
+        GameRecord toRecord() const;
+            // Return a copy of the record.
+    private:
+        friend class GameRecordReader;
+        const std::uint8_t* m_data; // the record's first byte
+        std::uint32_t read32(int offset) const;
+        int nameOffset() const { return 12 + 2 * (2 * holes() + 2); }
+            // Return the offset in the record of SOUTH's name.
+    };
+    GameRecordReader();
+        // Construct a GameRecordReader with no file open.
+    ~GameRecordReader();
+    GameRecordReader(const GameRecordReader&) = delete;
+    GameRecordReader& operator=(const GameRecordReader&) = delete;
+    bool open(const std::string& path);
+        // Memory-map the record file at the indicated path, closing any that was open, and get ready
+        // to read its first record. Return false (leaving no file open) if the file can't be
+        // opened or isn't a record file.
+    void close();
+        // Unmap the open file, if any.
+    bool isOpen() const { return m_mapping != nullptr; }
+        // Return true if a file is open.
+    bool next(Entry& entry);
+        // Set entry to the next record in the file and return true, or return false if there are
+        // no more (or the rest of the file isn't made of whole, well-formed records, in which case
+        // damaged returns true).
+    void rewind() { m_offset = m_start; m_damaged = false; }
+        // Go back to the first record.
+    bool damaged() const { return m_damaged; }
+        // Return true if next found a record that runs past the end of the file or is malformed.
+private:
+    void* m_mapping; // the mapped file
+    std::size_t m_mappingSize;
+    std::size_t m_start; // offset of the first record
+    std::size_t m_offset; // offset of the record next will return
+    bool m_damaged;
+};
+
+//////////
+
+template <class F>
+bool GameRecordReader::Entry::replay(Board& b, F visit) const
+{
+    b = startBoard();
+    Side s = SOUTH;
+    int n = sowings();
+    const std::uint8_t* hole = m_data + nameOffset() + m_data[9] + m_data[10];
+    for (int i = 0; i < n; i++)
+    {
+        Board::Undo undo;
+        if (!b.makeMove(s, hole[i], undo))
+            return false;
+        visit(b, s, static_cast<int>(hole[i]));
+        // the same side sows again if its last bean landed in its pot and the game isn't over
+        if (!undo.extraTurn() || b.beansInPlay(SOUTH) == 0 || b.beansInPlay(NORTH) == 0)
+            s = opponent(s);
+    }
+    return true;
+}
+
+#endif /* GameRecord_h */
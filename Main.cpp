@@ -1,11 +1,590 @@
 #include "Game.h"
+#include "GameHost.h"
+#include "GameObserver.h"
+#include "GameRecord.h"
 #include "Player.h"
 #include "Board.h"
+#include "BoardBatch.h"
+#include "EndgameDatabase.h"
+#include "Search.h"
+#include "Solver.h"
+#include "Tournament.h"
 #include "Side.h"
 #include <iostream>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <random>
+#include <thread>
+#include <vector>
 using namespace std;
 
+bool samePosition(const Board& a, const Board& b)
+// Return true if boards a and b have the same beans in every hole and pot, the same counts of
+// beans in play and in all, and the hash of a board set up from scratch with those beans.
+{
+    if (a.holes() != b.holes())
+        return false;
+    Board fresh(a.holes(), 0);
+    for (int hole = 0; hole <= a.holes(); hole++)
+    {
+        if (a.beans(SOUTH, hole) != b.beans(SOUTH, hole) || a.beans(NORTH, hole) != b.beans(NORTH, hole))
+            return false;
+        fresh.setBeans(SOUTH, hole, a.beans(SOUTH, hole));
+        fresh.setBeans(NORTH, hole, a.beans(NORTH, hole));
+    }
+    return a.beansInPlay(SOUTH) == fresh.beansInPlay(SOUTH) && b.beansInPlay(SOUTH) == fresh.beansInPlay(SOUTH)
+        && a.beansInPlay(NORTH) == fresh.beansInPlay(NORTH) && b.beansInPlay(NORTH) == fresh.beansInPlay(NORTH)
+        && a.totalBeans() == fresh.totalBeans() && b.totalBeans() == fresh.totalBeans()
+        && a.hash() == fresh.hash() && b.hash() == fresh.hash();
+}
+
+Board randomBoard(mt19937& rng, int nHoles)
+// Return a board with the indicated number of holes and a random number of beans in each hole and
+// pot, now and then enough for a sowing to go round the board more than once.
+{
+    Board b(nHoles, 0);
+    for (int hole = 0; hole <= nHoles; hole++)
+    {
+        b.setBeans(SOUTH, hole, rng() % 4 == 0 ? rng() % (4 * nHoles + 8) : rng() % 5);
+        b.setBeans(NORTH, hole, rng() % 4 == 0 ? rng() % (4 * nHoles + 8) : rng() % 5);
+    }
+    return b;
+}
+
+void checkMove(const Board& start, Side s, int hole)
+// Make move (s,hole) on a copy of start with makeMove and check it against sow and moveToPot
+// with the capture rule, then unmake it and check that the board is exactly start again.
+{
+    Board expected(start);
+    Side endSide = SOUTH;
+    int endHole = 0;
+    bool legal = expected.sow(s, hole, endSide, endHole);
+    int captured = 0;
+    if (legal && endSide == s && endHole != POT && expected.beans(s, endHole) == 1
+        && expected.beans(opponent(s), endHole) > 0)
+    {
+        captured = expected.beans(opponent(s), endHole);
+        expected.moveToPot(s, endHole, s);
+        expected.moveToPot(opponent(s), endHole, s);
+    }
+    Board b(start);
+    Board::Undo undo;
+    assert(b.makeMove(s, hole, undo) == legal);
+    assert(samePosition(b, expected));
+    if (!legal)
+        return;
+    assert(undo.m_endSide == endSide && undo.m_endHole == endHole && undo.m_captured == captured);
+    assert(undo.extraTurn() == (endSide == s && endHole == POT));
+    b.unmakeMove(undo);
+    assert(samePosition(b, start));
+}
+
+void doBoardTests()
+{
+    // an extra turn: the last of 4 beans from SOUTH's hole 3 lands in SOUTH's pot
+    Board b(6, 4);
+    Board::Undo undo;
+    assert(b.makeMove(SOUTH, 3, undo) && undo.extraTurn() && undo.m_captured == 0);
+    assert(b.beans(SOUTH, POT) == 1 && b.beans(SOUTH, 3) == 0 && b.beans(SOUTH, 6) == 5);
+    b.unmakeMove(undo);
+    assert(samePosition(b, Board(6, 4)));
+
+    // a capture: SOUTH's bean from hole 1 lands in empty hole 2, opposite NORTH's 3 beans
+    //   0  3  0
+    // 0         0
+    //   1  0  0
+    Board c(3, 0);
+    c.setBeans(SOUTH, 1, 1);
+    c.setBeans(NORTH, 2, 3);
+    Board before(c);
+    assert(c.makeMove(SOUTH, 1, undo) && !undo.extraTurn() && undo.m_captured == 3);
+    assert(c.beans(SOUTH, POT) == 4 && c.beans(SOUTH, 2) == 0 && c.beans(NORTH, 2) == 0
+           && c.beansInPlay(SOUTH) == 0 && c.beansInPlay(NORTH) == 0 && c.totalBeans() == 4);
+    c.unmakeMove(undo);
+    assert(samePosition(c, before));
+
+    // more than one lap: 13 beans from SOUTH's hole 1 on a 2-hole board go round the 5 slots
+    // SOUTH sows into (S2, S pot, N2, N1, S1) twice, then 3 more, ending in NORTH's hole 2
+    Board d(2, 0);
+    d.setBeans(SOUTH, 1, 13);
+    assert(d.makeMove(SOUTH, 1, undo) && undo.m_endSide == NORTH && undo.m_endHole == 2);
+    assert(d.beans(SOUTH, 1) == 2 && d.beans(SOUTH, 2) == 3 && d.beans(SOUTH, POT) == 3
+           && d.beans(NORTH, 1) == 2 && d.beans(NORTH, 2) == 3 && d.beans(NORTH, POT) == 0);
+    d.unmakeMove(undo);
+    assert(d.beans(SOUTH, 1) == 13 && d.totalBeans() == 13 && d.beansInPlay(NORTH) == 0);
+
+    // empty, invalid and pot holes change nothing
+    assert(!d.makeMove(SOUTH, 2, undo) && !d.makeMove(SOUTH, POT, undo) && !d.makeMove(SOUTH, 3, undo)
+           && !d.makeMove(NORTH, -1, undo));
+
+    // every move, legal or not, on random boards of every size the fixed-size boards cover and
+    // then some (heap-allocated ones included)
+    mt19937 rng(2024);
+    for (int k = 0; k < 3000; k++)
+    {
+        int nHoles = 1 + k % 18;
+        Board r = randomBoard(rng, nHoles);
+        for (int hole = -1; hole <= nHoles + 1; hole++)
+        {
+            checkMove(r, SOUTH, hole);
+            checkMove(r, NORTH, hole);
+        }
+    }
+
+    // a long line of moves, unmade in reverse order, restores the board
+    for (int k = 0; k < 200; k++)
+    {
+        int nHoles = 1 + k % 8;
+        Board r = randomBoard(rng, nHoles);
+        Board start(r);
+        vector<Board::Undo> undos;
+        Side s = SOUTH;
+        for (int m = 0; m < 40 && r.beansInPlay(s) > 0; m++)
+        {
+            int hole = 1 + rng() % nHoles;
+            while (r.beans(s, hole) == 0)
+                hole = hole % nHoles + 1;
+            Board::Undo u;
+            assert(r.makeMove(s, hole, u));
+            undos.push_back(u);
+            if (!u.extraTurn())
+                s = opponent(s);
+        }
+        while (!undos.empty())
+        {
+            r.unmakeMove(undos.back());
+            undos.pop_back();
+        }
+        assert(samePosition(r, start));
+    }
+}
+
+void doBatchTests()
+{
+    // every move on batches of random boards (of sizes that don't fill a whole number of vectors,
+    // so the leftover boards are done too) has exactly the outcome Board::makeMove has on each
+    mt19937 rng(7);
+    for (int k = 0; k < 400; k++)
+    {
+        int nHoles = 1 + k % 12;
+        int nBoards = 1 + rng() % 37;
+        BoardBatch batch(nHoles, nBoards);
+        vector<Board> boards;
+        for (int i = 0; i < nBoards; i++)
+        {
+            boards.push_back(randomBoard(rng, nHoles));
+            if (i % 5 == 0) // some boards with nothing in play on one side
+                for (int hole = 1; hole <= nHoles; hole++)
+                    boards[i].setBeans(i % 2 == 0 ? SOUTH : NORTH, hole, 0);
+            assert(batch.setBoard(i, boards[i]));
+        }
+        assert(batch.size() == nBoards && batch.holes() == nHoles);
+        assert(!batch.setBoard(nBoards, boards[0]) && !batch.setBoard(0, Board(nHoles + 1, 0)));
+        for (int m = 0; m < 6; m++)
+        {
+            Side s = (rng() % 2 == 0 ? SOUTH : NORTH);
+            int hole = static_cast<int>(rng() % (nHoles + 3)) - 1; // -1 to nHoles + 1
+            batch.makeMove(s, hole);
+            for (int i = 0; i < nBoards; i++)
+            {
+                Board::Undo undo;
+                bool moved = boards[i].makeMove(s, hole, undo);
+                assert(batch.moved(i) == moved);
+                assert(samePosition(batch.board(i), boards[i]));
+                for (int h = 0; h <= nHoles; h++)
+                    assert(batch.beans(i, SOUTH, h) == boards[i].beans(SOUTH, h)
+                           && batch.beans(i, NORTH, h) == boards[i].beans(NORTH, h));
+                if (moved)
+                    assert(batch.endSide(i) == undo.m_endSide && batch.endHole(i) == undo.m_endHole
+                           && batch.captured(i) == undo.m_captured);
+                else
+                    assert(batch.captured(i) == 0);
+            }
+        }
+        assert(batch.beans(nBoards, SOUTH, 1) == -1 && batch.beans(0, SOUTH, nHoles + 1) == -1);
+    }
+}
+
+int exactMargin(Board& b, Side s)
+// Return the beans SOUTH will win from the holes of b minus the beans NORTH will, with s to move
+// and both sides playing perfectly, by searching every line to the end of the game.
+{
+    if (b.beansInPlay(SOUTH) == 0 || b.beansInPlay(NORTH) == 0)
+        return b.beansInPlay(SOUTH) - b.beansInPlay(NORTH);
+    int best = (s == SOUTH ? INT_MIN : INT_MAX);
+    for (int hole = 1; hole <= b.holes(); hole++)
+    {
+        int potDiff = b.beans(SOUTH, POT) - b.beans(NORTH, POT);
+        Board::Undo undo;
+        if (!b.makeMove(s, hole, undo))
+            continue;
+        int margin = b.beans(SOUTH, POT) - b.beans(NORTH, POT) - potDiff
+            + exactMargin(b, undo.extraTurn() ? s : opponent(s));
+        b.unmakeMove(undo);
+        if (s == SOUTH ? margin > best : margin < best)
+            best = margin;
+    }
+    return best;
+}
+
+int minimax(Board& b, Side s, int depth);
+
+int minimaxAfter(Board& b, Side s, int hole, int depth)
+// Return the value plain minimax finds for sowing (s,hole) (which must be legal) and playing on
+// from there, the turn counting as the first of depth turns (or to the end of the game if depth
+// is negative).
+{
+    Board::Undo undo;
+    b.makeMove(s, hole, undo);
+    int v;
+    if (undo.extraTurn() && b.beansInPlay(SOUTH) > 0 && b.beansInPlay(NORTH) > 0)
+        v = minimax(b, s, depth); // the same turn goes on
+    else
+        v = minimax(b, opponent(s), depth - 1);
+    b.unmakeMove(undo);
+    return v;
+}
+
+int minimax(Board& b, Side s, int depth)
+// Return the value of the position with s to move, found by plain minimax over every sowing,
+// depth turns deep (or to the end of the game if depth is negative), with Search's evaluation.
+{
+    if (depth == 0 || b.beansInPlay(SOUTH) == 0 || b.beansInPlay(NORTH) == 0)
+        return evaluate(b);
+    int value = (s == SOUTH ? -WIN_VALUE - 1 : WIN_VALUE + 1);
+    for (int hole = 1; hole <= b.holes(); hole++)
+        if (b.beans(s, hole) > 0)
+        {
+            int v = minimaxAfter(b, s, hole, depth);
+            if (s == SOUTH ? v > value : v < value)
+                value = v;
+        }
+    return value;
+}
+
+void checkSearch(Board b, Side s, int depth, Search<Board>& search)
+// Check that search finds the value plain minimax does for board b with s to move at the
+// indicated depth (or to the end of the game if depth is negative), and the same best move: the
+// highest numbered hole among the best.
+{
+    int value = 0, bestHole = -1;
+    for (int hole = 1; hole <= b.holes(); hole++)
+        if (b.beans(s, hole) > 0)
+        {
+            int v = minimaxAfter(b, s, hole, depth);
+            if (bestHole == -1 || (s == SOUTH ? v >= value : v <= value))
+            {
+                value = v;
+                bestHole = hole;
+            }
+        }
+    int hole;
+    if (depth >= 0)
+        assert(search.searchRoot(s, depth, hole) == value && hole == bestHole);
+    else
+    {
+        // iterative deepening, until a depth reaches the end of the game on every line
+        int v, d = 0;
+        do
+            v = search.searchRoot(s, ++d, hole);
+        while (!search.complete());
+        assert(v == value && hole == bestHole);
+    }
+}
+
+void doSearchTests()
+{
+    // alpha-beta over whole turns (with duplicate turns dropped) finds what plain minimax over
+    // every sowing does: at each depth without a transposition table; at each depth of iterative
+    // deepening with one (on these boards, no position recurs a different number of turns from
+    // the root, where the table would rightly give the deeper result); and to the end of the game
+    mt19937 rng(8);
+    TranspositionTable table(1);
+    for (int i = 0; i < 200; i++)
+    {
+        int nHoles = 3 + i % 4;
+        Board b = randomBoard(rng, nHoles);
+        Side s = (i % 2 == 0 ? SOUTH : NORTH);
+        if (b.beansInPlay(SOUTH) == 0 || b.beansInPlay(NORTH) == 0)
+            continue;
+        Board copy(b);
+        SearchLimits limits;
+        Search<Board> search(copy, limits);
+        for (int depth = 1; depth <= 3; depth++)
+            checkSearch(b, s, depth, search);
+        table.clear();
+        Search<Board> deepening(copy, limits, &table);
+        for (int depth = 1; depth <= 4; depth++)
+            checkSearch(b, s, depth, deepening);
+        assert(samePosition(copy, b));
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        int nHoles = 3;
+        vector<int> slots(2 * nHoles + 2);
+        for (size_t k = 0; k < slots.size(); k++)
+            slots[k] = rng() % 4;
+        Board b(nHoles, slots.data());
+        Side s = (i % 2 == 0 ? SOUTH : NORTH);
+        if (b.beansInPlay(SOUTH) == 0 || b.beansInPlay(NORTH) == 0)
+            continue;
+        Board copy(b);
+        SearchLimits limits;
+        table.clear();
+        Search<Board> search(copy, limits, &table);
+        checkSearch(b, s, -1, search);
+        assert(samePosition(copy, b));
+    }
+}
+
+void doEndgameTests()
+{
+    // every position of a small database has the margin found by searching every line to the end
+    // of the game, and the margin Solver proves for it, pots and all
+    const char* path = "endgame_test.tmp";
+    assert(EndgameDatabase::generate(3, 6, path));
+    EndgameDatabase db;
+    assert(db.open(path) && db.holes() == 3 && db.maxBeans() == 6);
+    Solver solver(1);
+    int positions = 0;
+    for (int code = 0; code < 7 * 7 * 7 * 7 * 7 * 7; code++)
+    {
+        Board b(3, 0);
+        int left = 0;
+        for (int i = 0, c = code; i < 6; i++, c /= 7)
+        {
+            b.setBeans(i < 3 ? SOUTH : NORTH, i % 3 + 1, c % 7);
+            left += c % 7;
+        }
+        if (left > 6)
+            continue;
+        positions++;
+        b.setBeans(SOUTH, POT, code % 5);
+        b.setBeans(NORTH, POT, code % 3);
+        for (int k = 0; k < 2; k++)
+        {
+            Side s = (k == 0 ? SOUTH : NORTH);
+            int margin;
+            assert(db.probe(b, s, margin));
+            Board copy(b);
+            assert(exactMargin(copy, s) == margin);
+            Solver::Result result;
+            assert(solver.solve(b, s, SearchLimits(), result));
+            assert(result.margin() == margin + b.beans(SOUTH, POT) - b.beans(NORTH, POT));
+        }
+    }
+    assert(positions == 924);
+    int margin;
+    assert(!db.probe(Board(3, 3), SOUTH, margin) && !db.probe(Board(4, 1), SOUTH, margin));
+    db.close();
+    assert(!db.isOpen() && !db.probe(Board(3, 0), SOUTH, margin));
+    remove(path);
+}
+
+class SowingLog : public GameObserver
+{
+    // Keeps the side and hole of every sowing of a game, to compare with the game's record.
+public:
+    vector<pair<Side, int> > m_sowings;
+    virtual void moved(const Board&, Side s, int hole) { m_sowings.push_back(make_pair(s, hole)); }
+};
+
+void doRecordTests()
+{
+    // games written to a record file read back with the same players and starting boards, and
+    // replay to the same sowings and final pots: a tie, games with names as long as the format
+    // allows, and a game of more than 255 sowings
+    const char* path = "records_test.tmp";
+    const char* truncatedPath = "records_truncated_test.tmp";
+    remove(path);
+    BadPlayer shortName("Bart");
+    BadPlayer longName(string(255, 'L'));
+    const int nGames = 4;
+    Board boards[nGames] = { Board(1, 1), Board(3, 2), Board(6, 4), Board(16, 20) };
+    vector<pair<Side, int> > sowings[nGames];
+    int southPots[nGames], northPots[nGames];
+    {
+        GameRecordWriter writer;
+        assert(writer.open(path));
+        for (int i = 0; i < nGames; i++)
+        {
+            SowingLog log;
+            Game g(boards[i], i % 2 == 0 ? &shortName : &longName,
+                   i % 2 == 0 ? &longName : &shortName);
+            g.setObserver(&log);
+            g.setRecordWriter(&writer);
+            g.play();
+            bool over, hasWinner;
+            Side winner;
+            g.status(over, hasWinner, winner);
+            assert(over && hasWinner == (i != 0)); // Board(1, 1) ends 1 to 1
+            sowings[i] = log.m_sowings;
+            // a game that ends as a turn ends isn't swept
+            southPots[i] = g.beans(SOUTH, POT);
+            northPots[i] = g.beans(NORTH, POT);
+            for (int hole = 1; hole <= boards[i].holes(); hole++)
+            {
+                southPots[i] += g.beans(SOUTH, hole);
+                northPots[i] += g.beans(NORTH, hole);
+            }
+        }
+        assert(sowings[nGames - 1].size() > 255);
+        GameRecord tooLong;
+        tooLong.m_southName = string(256, 'L');
+        assert(!writer.write(tooLong) && writer.records() == nGames);
+    }
+    GameRecordReader reader;
+    assert(reader.open(path));
+    GameRecordReader::Entry entry;
+    for (int i = 0; i < nGames; i++)
+    {
+        assert(reader.next(entry));
+        assert(entry.southName() == (i % 2 == 0 ? shortName : longName).name()
+               && entry.northName() == (i % 2 == 0 ? longName : shortName).name());
+        assert(samePosition(entry.startBoard(), boards[i]));
+        assert(entry.sowings() == static_cast<int>(sowings[i].size()));
+        size_t k = 0;
+        Board b(1, 0);
+        assert(entry.replay(b, [&](const Board&, Side s, int hole) {
+            assert(k < sowings[i].size() && sowings[i][k] == make_pair(s, hole));
+            k++;
+        }));
+        assert(k == sowings[i].size());
+        // replay leaves the end-of-game sweep out too
+        assert(b.beans(SOUTH, POT) + b.beansInPlay(SOUTH) == southPots[i]
+               && b.beans(NORTH, POT) + b.beansInPlay(NORTH) == northPots[i]);
+    }
+    assert(!reader.next(entry) && !reader.damaged());
+    reader.close();
+
+    // a file cut off partway through its last record reads as the records before it, then damaged
+    {
+        ifstream in(path, ios::binary);
+        string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        ofstream out(truncatedPath, ios::binary | ios::trunc);
+        out.write(bytes.data(), bytes.size() - 100);
+    }
+    assert(reader.open(truncatedPath));
+    for (int i = 0; i < nGames - 1; i++)
+        assert(reader.next(entry) && !reader.damaged());
+    assert(!reader.next(entry) && reader.damaged());
+    reader.rewind();
+    assert(!reader.damaged() && reader.next(entry) && entry.sowings() == 1);
+    reader.close();
+    remove(path);
+    remove(truncatedPath);
+}
+
+class CancelWatcher : public GameObserver
+{
+    // Notices any event of a game that comes after the game has been cancelled.
+public:
+    CancelWatcher() : m_cancelled(false), m_late(false), m_over(false) {}
+    atomic<bool> m_cancelled; // set once GameHost::cancel has returned
+    atomic<bool> m_late; // an event came after that
+    atomic<bool> m_over; // the game was told it's over
+    virtual void moved(const Board&, Side, int)
+    {
+        m_late = m_late || m_cancelled;
+        // take a while over it, so cancels come while sowings are being made
+        this_thread::sleep_for(chrono::microseconds(20));
+    }
+    virtual void turnEnded(const Board&, Side) { m_late = m_late || m_cancelled; }
+    virtual void swept(const Board&) { m_late = m_late || m_cancelled; }
+    virtual void gameOver(const Board&, bool, Side)
+    {
+        m_late = m_late || m_cancelled;
+        m_over = true;
+    }
+};
+
+void doHostTests()
+{
+    // games cancelled while their moves are being delivered on other threads have nothing happen
+    // to them once cancel returns, and aren't recorded or told they're over; the rest finish
+    const char* path = "host_test.tmp";
+    remove(path);
+    const int nGames = 200;
+    vector<unique_ptr<Player> > players;
+    vector<unique_ptr<CancelWatcher> > watchers;
+    GameRecordWriter writer;
+    assert(writer.open(path));
+    {
+        GameHost host(4);
+        for (int g = 0; g < nGames; g++)
+        {
+            players.push_back(unique_ptr<Player>(new BadPlayer("South")));
+            players.push_back(unique_ptr<Player>(new BadPlayer("North")));
+            watchers.push_back(unique_ptr<CancelWatcher>(new CancelWatcher));
+            host.add(Board(6 + g % 7, 4), players[2 * g].get(), players[2 * g + 1].get(),
+                     watchers[g].get(), &writer);
+        }
+        for (int g = 0; g < nGames; g += 2)
+        {
+            host.cancel(g);
+            watchers[g]->m_cancelled = true;
+            this_thread::sleep_for(chrono::microseconds(100)); // let the games go on a bit
+        }
+        host.wait();
+        long finished = 0;
+        for (int g = 0; g < nGames; g++)
+        {
+            bool hasWinner;
+            Side winner;
+            int southBeans, northBeans;
+            assert(host.over(g) && !watchers[g]->m_late);
+            if (host.result(g, hasWinner, winner, southBeans, northBeans))
+            {
+                assert(watchers[g]->m_over);
+                finished++;
+            }
+            else
+                assert(g % 2 == 0 && !watchers[g]->m_over);
+        }
+        assert(writer.records() == finished && host.playing() == 0);
+    }
+    writer.close();
+    remove(path);
+}
+
+void doTournamentTests()
+{
+    // a score's Elo interval holds its Elo and has some width, even when every game was won or
+    // lost, and narrows as more games are played
+    Tournament::Record none, allWon, fewWon, manyWon, even;
+    allWon.m_wins = 12;
+    fewWon.m_wins = 3;
+    fewWon.m_draws = 2;
+    fewWon.m_losses = 1;
+    manyWon.m_wins = 300;
+    manyWon.m_draws = 200;
+    manyWon.m_losses = 100;
+    even.m_wins = even.m_losses = 50;
+    Tournament::Record records[] = { none, allWon, fewWon, manyWon, even };
+    double width[5];
+    for (int i = 0; i < 5; i++)
+    {
+        double low, high;
+        records[i].eloInterval(low, high);
+        assert(low <= records[i].elo() && records[i].elo() <= high && low < high);
+        width[i] = high - low;
+    }
+    double low, high;
+    allWon.eloInterval(low, high);
+    assert(allWon.elo() > 1000 && high == allWon.elo() && low > 0 && low < 1000);
+    even.eloInterval(low, high);
+    assert(even.elo() == 0 && low < -50 && low + high > -1e-9 && low + high < 1e-9);
+    assert(width[3] < width[2] && width[0] > width[1]);
+}
+
 void doGameTests()
 {
     BadPlayer bp1("Bart");
@@ -68,6 +647,13 @@ void doGameTests()
 
 int main()
 {
+    doBoardTests();
+    doBatchTests();
+    doSearchTests();
+    doEndgameTests();
+    doRecordTests();
+    doHostTests();
+    doTournamentTests();
     doGameTests();
     cout << "Passed all tests" << endl;
 }
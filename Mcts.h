@@ -0,0 +1,235 @@
+#ifndef Mcts_h
+#define Mcts_h
+#include "Side.h"
+#include "SearchLimits.h"
+#include "BoardLayout.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//==========================================================================
+// Mcts<B> is MctsPlayer's search: Monte Carlo tree search with the UCT selection rule over a board
+// of type B (Board or one of the BoardT<N>). Each iteration walks down the tree from the root,
+// choosing at each node the child with the best upper confidence bound, adds the children of the
+// node it stops at, plays the game out from there with quick, nearly random moves, and credits
+// the result to every node on the way down. The moves are made with the board's own makeMove (so
+// sowing, captures and extra turns follow exactly the rules the Game uses) and taken back with
+// unmakeMove, so one board is used for the whole search.
+//
+// The tree's nodes live in an arena, a vector the caller owns and can reuse from one search to the
+// next, and refer to each other by index, so growing the tree doesn't allocate a node at a time.
+// One Mcts, with its own board and arena, is meant to run on each thread, each building its own
+// tree (root parallelization); the caller adds up their statistics for the moves at the root.
+//==========================================================================
+
+struct MctsNode
+{
+    int m_firstChild; // index of the first child in the arena (the rest follow it), or -1
+    int m_nChildren; // number of children, once m_firstChild isn't -1
+    int m_hole; // move that led here
+    Side m_mover; // side that made that move
+    int m_visits; // number of playouts through this node
+    double m_reward; // total result of those playouts for m_mover (1 win, 1/2 tie, 0 loss)
+};
+
+template <class B>
+class Mcts
+{
+public:
+    Mcts(B& b, std::vector<MctsNode>& arena, std::uint64_t seed);
+        // Prepare to search position b (which is changed during the search, but restored by the
+        // end of it), keeping the tree in arena (whose contents are discarded), with random moves
+        // that depend on seed.
+    void run(Side s, const SearchLimits& limits, std::atomic<long>* budget, int maxNodes);
+        // Search the position with s to move until limits are reached (counting playouts as the
+        // positions visited) or, if budget isn't null, until *budget (the number of playouts left,
+        // shared by every thread) runs out. The tree grows to at most maxNodes nodes; after that,
+        // playouts start from its leaves.
+    void rootStats(std::vector<long>& visits, std::vector<double>& rewards) const;
+        // Add the number of playouts through each move at the root, and their total result for
+        // the side to move there, to visits[hole] and rewards[hole].
+    long playouts() const { return m_playouts; }
+        // Return the number of playouts done.
+private:
+    B& m_board;
+    std::vector<MctsNode>& m_arena;
+    std::uint64_t m_random; // state of the random number generator
+    long m_playouts;
+    std::vector<typename B::Undo> m_undos; // moves made since the root, to take back
+    std::vector<int> m_path; // nodes visited by the current iteration
+    std::vector<int> m_moves; // room for a playout's list of moves
+    int random(int n);
+        // Return a random number from 0 to n - 1.
+    int select(int node) const;
+        // Return the child of node with the best upper confidence bound for the side to move there.
+    void expand(int node, Side toMove);
+        // Add a child to node for every legal move of toMove.
+    double playout(Side toMove);
+        // Play the game out with toMove to move and return the result for SOUTH.
+    bool gameOver() const
+        { return m_board.beansInPlay(SOUTH) == 0 || m_board.beansInPlay(NORTH) == 0; }
+};
+
+//////////
+
+template <class B>
+Mcts<B>::Mcts(B& b, std::vector<MctsNode>& arena, std::uint64_t seed)
+: m_board(b), m_arena(arena), m_random(splitMix64(seed)), m_playouts(0)
+{
+    if (m_random == 0) // xorshift needs a nonzero state
+        m_random = 1;
+    MctsNode root = { -1, 0, 0, NORTH, 0, 0.0 };
+    m_arena.clear();
+    m_arena.push_back(root);
+    m_moves.resize(b.holes());
+}
+
+template <class B>
+void Mcts<B>::run(Side s, const SearchLimits& limits, std::atomic<long>* budget, int maxNodes)
+{
+    // a playout takes much longer than visiting one position in Search, so check the limits
+    // more often
+    const long CHECK_INTERVAL = 16;
+    while (!((m_playouts & (CHECK_INTERVAL - 1)) == 0 && limits.reached(m_playouts))
+           && (budget == nullptr || budget->fetch_sub(1) > 0))
+    {
+        // walk down the tree to a leaf
+        int node = 0;
+        Side toMove = s;
+        m_path.assign(1, 0);
+        while (m_arena[node].m_nChildren > 0)
+        {
+            node = select(node);
+            typename B::Undo undo;
+            m_board.makeMove(toMove, m_arena[node].m_hole, undo);
+            m_undos.push_back(undo);
+            if (!undo.extraTurn())
+                toMove = opponent(toMove);
+            m_path.push_back(node);
+        }
+        // the first time through a leaf, just play out from it; the second time, give it children
+        // and play out from the first
+        if ((node == 0 || m_arena[node].m_visits > 0) && m_arena[node].m_firstChild == -1
+            && !gameOver() && static_cast<int>(m_arena.size()) + m_board.holes() <= maxNodes)
+        {
+            expand(node, toMove);
+            node = m_arena[node].m_firstChild;
+            typename B::Undo undo;
+            m_board.makeMove(toMove, m_arena[node].m_hole, undo);
+            m_undos.push_back(undo);
+            if (!undo.extraTurn())
+                toMove = opponent(toMove);
+            m_path.push_back(node);
+        }
+        double south = playout(toMove);
+        m_playouts++;
+        for (size_t i = 0; i < m_path.size(); i++)
+        {
+            MctsNode& n = m_arena[m_path[i]];
+            n.m_visits++;
+            n.m_reward += (n.m_mover == SOUTH ? south : 1 - south);
+        }
+        while (!m_undos.empty()) // back to the root position
+        {
+            m_board.unmakeMove(m_undos.back());
+            m_undos.pop_back();
+        }
+    }
+}
+
+template <class B>
+void Mcts<B>::rootStats(std::vector<long>& visits, std::vector<double>& rewards) const
+{
+    const MctsNode& root = m_arena[0];
+    for (int i = 0; i < root.m_nChildren; i++)
+    {
+        const MctsNode& child = m_arena[root.m_firstChild + i];
+        visits[child.m_hole] += child.m_visits;
+        rewards[child.m_hole] += child.m_reward;
+    }
+}
+
+template <class B>
+int Mcts<B>::random(int n)
+{
+    // xorshift64*
+    m_random ^= m_random >> 12;
+    m_random ^= m_random << 25;
+    m_random ^= m_random >> 27;
+    return static_cast<int>(((m_random * 0x2545F4914F6CDD1DULL) >> 32) % n);
+}
+
+template <class B>
+int Mcts<B>::select(int node) const
+{
+    // UCB1: average result for the mover plus an exploration term that grows for children tried
+    // less often than their siblings; children never tried come first
+    const double EXPLORATION = 1.4;
+    const MctsNode& parent = m_arena[node];
+    double logVisits = std::log(static_cast<double>(parent.m_visits + 1));
+    int best = parent.m_firstChild;
+    double bestScore = -1;
+    for (int c = parent.m_firstChild; c < parent.m_firstChild + parent.m_nChildren; c++)
+    {
+        const MctsNode& child = m_arena[c];
+        if (child.m_visits == 0)
+            return c;
+        double score = child.m_reward / child.m_visits
+                     + EXPLORATION * std::sqrt(logVisits / child.m_visits);
+        if (score > bestScore)
+        {
+            best = c;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+template <class B>
+void Mcts<B>::expand(int node, Side toMove)
+{
+    int first = static_cast<int>(m_arena.size());
+    for (int hole = 1; hole <= m_board.holes(); hole++)
+        if (m_board.beans(toMove, hole) > 0)
+        {
+            MctsNode child = { -1, 0, hole, toMove, 0, 0.0 };
+            m_arena.push_back(child); // may move the arena, so look node up again below
+        }
+    m_arena[node].m_firstChild = first;
+    m_arena[node].m_nChildren = static_cast<int>(m_arena.size()) - first;
+}
+
+template <class B>
+double Mcts<B>::playout(Side toMove)
+{
+    // take a move that earns an extra turn if there is one (it's almost always good), otherwise
+    // a random one
+    int* moves = m_moves.data();
+    while (!gameOver())
+    {
+        int n = 0, hole = 0;
+        for (int h = 1; h <= m_board.holes() && hole == 0; h++)
+        {
+            Side endSide; int endHole;
+            if (!m_board.landing(toMove, h, endSide, endHole))
+                continue;
+            if (endSide == toMove && endHole == POT)
+                hole = h;
+            else
+                moves[n++] = h;
+        }
+        if (hole == 0)
+            hole = moves[random(n)];
+        typename B::Undo undo;
+        m_board.makeMove(toMove, hole, undo);
+        m_undos.push_back(undo);
+        if (!undo.extraTurn())
+            toMove = opponent(toMove);
+    }
+    int south = m_board.beansInPlay(SOUTH) + m_board.beans(SOUTH, POT);
+    int north = m_board.beansInPlay(NORTH) + m_board.beans(NORTH, POT);
+    return south > north ? 1 : (south < north ? 0 : 0.5);
+}
+
+#endif /* Mcts_h */
@@ -0,0 +1,141 @@
+#include "OpeningBook.h"
+#include "BoardLayout.h"
+#include "Player.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+
+// A book file is this header followed by the keys and then the moves.
+struct FileHeader
+{
+    char m_magic[8];
+    std::uint32_t m_version;
+    std::uint32_t m_depth;
+    std::uint64_t m_entries;
+};
+
+const char MAGIC[8] = { 'K', 'A', 'L', 'A', 'H', 'B', 'O', 'K' };
+const std::uint32_t VERSION = 1;
+
+} // namespace
+
+OpeningBook::OpeningBook()
+// Construct an empty OpeningBook.
+: m_depth(0)
+{
+}
+
+bool OpeningBook::open(const std::string& path)
+// Read the book in the indicated file, replacing any that was open. Return false (leaving
+// the book empty) if the file can't be read or isn't a book.
+{
+    close();
+    std::ifstream in(path.c_str(), std::ios::binary);
+    FileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.m_magic, MAGIC, sizeof(MAGIC)) != 0 || header.m_version != VERSION)
+        return false;
+    // check the size before allocating anything, in case the header is garbage
+    std::streampos start = in.tellg();
+    in.seekg(0, std::ios::end);
+    if (in.tellg() - start != static_cast<std::streamoff>(header.m_entries * 9))
+        return false;
+    in.seekg(start);
+    m_keys.resize(header.m_entries);
+    m_moves.resize(header.m_entries);
+    if (!in.read(reinterpret_cast<char*>(m_keys.data()), m_keys.size() * sizeof(std::uint64_t))
+        || !in.read(reinterpret_cast<char*>(m_moves.data()), m_moves.size())
+        || !std::is_sorted(m_keys.begin(), m_keys.end()))
+    {
+        close();
+        return false;
+    }
+    m_depth = header.m_depth;
+    return true;
+}
+
+void OpeningBook::close()
+// Empty the book.
+{
+    m_keys.clear();
+    m_moves.clear();
+    m_depth = 0;
+}
+
+bool OpeningBook::lookup(const Board& b, Side s, int& hole) const
+// If the book has a move for position b with s to move, set hole to it and return true.
+// Otherwise, return false.
+{
+    std::uint64_t key = positionKey(b, s);
+    std::vector<std::uint64_t>::const_iterator it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+    if (it == m_keys.end() || *it != key)
+        return false;
+    hole = m_moves[it - m_keys.begin()];
+    return true;
+}
+
+bool OpeningBook::build(const std::vector<Board>& starts, int plies, int depth, const std::string& path,
+                        int threads, std::ostream* progress)
+// Search every position that can be reached in at most plies sowings from one of the
+// starting positions (SOUTH moving first, as in a Game) to the indicated depth, using
+// the indicated number of threads (see SmartPlayer), and write the book of their moves to
+// the indicated file, reporting progress to *progress if it isn't null. Return false if
+// plies or depth isn't positive or the file can't be written.
+{
+    if (plies <= 0 || depth <= 0)
+        return false;
+    // The searcher keeps its transposition table from one position to the next, and the
+    // positions are searched a ply at a time, so later searches reuse much of the earlier ones.
+    SmartPlayer searcher("book", 0, depth, 256, threads);
+    std::unordered_set<std::uint64_t> seen;
+    std::vector<std::pair<std::uint64_t, std::uint8_t> > entries;
+    std::vector<std::pair<Board, Side> > level;
+    for (size_t i = 0; i < starts.size(); i++)
+        if (seen.insert(positionKey(starts[i], SOUTH)).second)
+            level.push_back(std::make_pair(starts[i], SOUTH));
+    for (int ply = 0; ply < plies && !level.empty(); ply++)
+    {
+        std::vector<std::pair<Board, Side> > next;
+        for (size_t i = 0; i < level.size(); i++)
+        {
+            Board& b = level[i].first;
+            Side s = level[i].second;
+            if (b.beansInPlay(SOUTH) == 0 || b.beansInPlay(NORTH) == 0) // game over; no move
+                continue;
+            int hole = searcher.chooseMove(b, s);
+            if (hole <= 255) // fits in the book
+                entries.push_back(std::make_pair(positionKey(b, s), static_cast<std::uint8_t>(hole)));
+            for (int h = 1; h <= b.holes(); h++) // every position one sowing later
+            {
+                Board child(b);
+                Board::Undo undo;
+                if (!child.makeMove(s, h, undo))
+                    continue;
+                Side toMove = undo.extraTurn() ? s : opponent(s);
+                if (seen.insert(positionKey(child, toMove)).second)
+                    next.push_back(std::make_pair(child, toMove));
+            }
+        }
+        if (progress != nullptr)
+            *progress << "searched " << level.size() << " positions " << ply << " sowings in" << std::endl;
+        level.swap(next);
+    }
+
+    std::sort(entries.begin(), entries.end());
+    FileHeader header;
+    std::memcpy(header.m_magic, MAGIC, sizeof(MAGIC));
+    header.m_version = VERSION;
+    header.m_depth = depth;
+    header.m_entries = entries.size();
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t i = 0; i < entries.size(); i++)
+        out.write(reinterpret_cast<const char*>(&entries[i].first), sizeof(entries[i].first));
+    for (size_t i = 0; i < entries.size(); i++)
+        out.write(reinterpret_cast<const char*>(&entries[i].second), 1);
+    return static_cast<bool>(out.flush());
+}
@@ -0,0 +1,54 @@
+#ifndef OpeningBook_h
+#define OpeningBook_h
+#include "Side.h"
+#include "Board.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//==========================================================================
+// An OpeningBook maps positions from the first few moves of a game to the move a deep search chose
+// for them, so a player can answer them without searching. Positions are identified by their
+// positionKey (BoardLayout.h), which includes the side to move and the board size, so one book can
+// hold the openings of several board sizes. The book's keys are sorted, and a lookup is a binary
+// search over them.
+//
+// build makes a book by searching every position that can be reached from given starting
+// positions in a given number of sowings (see tools/makebook.cpp) and writes it to a file: a small
+// header, then the sorted keys, then one byte per key with its move. open reads such a file.
+//==========================================================================
+
+class OpeningBook
+{
+public:
+    OpeningBook();
+        // Construct an empty OpeningBook.
+    bool open(const std::string& path);
+        // Read the book in the indicated file, replacing any that was open. Return false (leaving
+        // the book empty) if the file can't be read or isn't a book.
+    void close();
+        // Empty the book.
+    bool isOpen() const { return !m_keys.empty(); }
+        // Return true if the book has any positions.
+    int size() const { return static_cast<int>(m_keys.size()); }
+        // Return the number of positions in the book.
+    int depth() const { return m_depth; }
+        // Return how many turns deep the book's moves were searched.
+    bool lookup(const Board& b, Side s, int& hole) const;
+        // If the book has a move for position b with s to move, set hole to it and return true.
+        // Otherwise, return false.
+    static bool build(const std::vector<Board>& starts, int plies, int depth, const std::string& path,
+                      int threads = 0, std::ostream* progress = nullptr);
+        // Search every position that can be reached in at most plies sowings from one of the
+        // starting positions (SOUTH moving first, as in a Game) to the indicated depth, using
+        // the indicated number of threads (see SmartPlayer), and write the book of their moves to
+        // the indicated file, reporting progress to *progress if it isn't null. Return false if
+        // plies or depth isn't positive or the file can't be written.
+private:
+    std::vector<std::uint64_t> m_keys; // sorted
+    std::vector<std::uint8_t> m_moves; // m_moves[i] is the move for m_keys[i]
+    int m_depth;
+};
+
+#endif /* OpeningBook_h */
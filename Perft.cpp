@@ -0,0 +1,124 @@
+#include "Perft.h"
+#include "BoardT.h"
+#include "ThreadPool.h"
+#include <type_traits>
+
+namespace {
+
+template <class B>
+std::uint64_t leaves(B& b, Side s, int depth);
+
+template <class B>
+std::uint64_t sowings(B& b, Side s, int depth)
+// Return the leaves depth turns below the turns that can be finished from position b, where s
+// is in the middle of a turn (or starting one) and the game isn't over.
+{
+    std::uint64_t total = 0;
+    for (int hole = 1; hole <= b.holes(); hole++)
+    {
+        Side endSide;
+        int endHole;
+        if (!b.landing(s, hole, endSide, endHole)) // hole is empty
+            continue;
+        // on the last turn, a sowing that doesn't end in the pot ends the turn and makes a leaf,
+        // so it doesn't have to be made
+        if (depth == 1 && !(endSide == s && endHole == POT))
+        {
+            total++;
+            continue;
+        }
+        typename B::Undo undo;
+        b.makeMove(s, hole, undo);
+        if (undo.extraTurn() && b.beansInPlay(SOUTH) > 0 && b.beansInPlay(NORTH) > 0)
+            total += sowings(b, s, depth);
+        else
+            total += leaves(b, opponent(s), depth - 1);
+        b.unmakeMove(undo);
+    }
+    return total;
+}
+
+template <class B>
+std::uint64_t leaves(B& b, Side s, int depth)
+// Return the leaves depth turns below position b with s to move.
+{
+    if (depth == 0)
+        return 1;
+    if (b.beansInPlay(SOUTH) == 0 || b.beansInPlay(NORTH) == 0) // game over
+        return 0;
+    return sowings(b, s, depth);
+}
+
+template <class B>
+struct RootTurn
+{
+    PerftTurn m_turn;
+    B m_after; // the position the turn leaves
+};
+
+template <class B>
+void rootTurns(B& b, Side s, std::vector<int>& path, std::vector<RootTurn<B> >& turns)
+// Add every turn for s that begins with the sowings in path (already made on b) to turns.
+{
+    for (int hole = 1; hole <= b.holes(); hole++)
+    {
+        typename B::Undo undo;
+        if (!b.makeMove(s, hole, undo))
+            continue;
+        path.push_back(hole);
+        if (undo.extraTurn() && b.beansInPlay(SOUTH) > 0 && b.beansInPlay(NORTH) > 0)
+            rootTurns(b, s, path, turns);
+        else
+        {
+            RootTurn<B> turn = { { path, 0 }, b };
+            turns.push_back(turn);
+        }
+        path.pop_back();
+        b.unmakeMove(undo);
+    }
+}
+
+} // namespace
+
+std::uint64_t perft(const Board& b, Side s, int depth, int threads, std::vector<PerftTurn>* divide)
+// Return the number of sequences of depth complete turns that can be played from position b
+// with s to move (1 if depth is 0). The turns at the top are divided among threads threads
+// (one per processor core if threads isn't positive). If divide isn't null, set it to every
+// turn s can take, in order of their holes, with the leaves below each.
+{
+    if (divide != nullptr)
+        divide->clear();
+    if (depth <= 0)
+        return 1;
+    std::uint64_t total = 0;
+    withBoard(b, [&](auto& board) {
+        typedef typename std::decay<decltype(board)>::type B;
+        if (board.beansInPlay(SOUTH) == 0 || board.beansInPlay(NORTH) == 0) // game over
+            return;
+        std::vector<RootTurn<B> > turns;
+        std::vector<int> path;
+        rootTurns(board, s, path, turns);
+        if (threads == 1)
+        {
+            for (size_t i = 0; i < turns.size(); i++)
+                turns[i].m_turn.m_leaves = leaves(turns[i].m_after, opponent(s), depth - 1);
+        }
+        else
+        {
+            // each thread counts below the turns it's given, on the turn's own copy of the board
+            ThreadPool pool(threads);
+            for (size_t i = 0; i < turns.size(); i++)
+                pool.submit([&turns, i, s, depth]() {
+                    turns[i].m_turn.m_leaves = leaves(turns[i].m_after, opponent(s), depth - 1);
+                });
+            pool.wait();
+        }
+        for (size_t i = 0; i < turns.size(); i++)
+        {
+            total += turns[i].m_turn.m_leaves;
+            if (divide != nullptr)
+                divide->push_back(turns[i].m_turn);
+        }
+    });
+    return total;
+}
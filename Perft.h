@@ -0,0 +1,37 @@
+#ifndef Perft_h
+#define Perft_h
+#include "Board.h"
+#include "Side.h"
+#include <cstdint>
+#include <vector>
+
+//==========================================================================
+// perft ("performance test", after the chess programs' move generation test) counts the leaves of
+// the game tree a given number of turns deep: every sequence of that many complete turns that can
+// be played from a position, with turns following the rules in Game::move. A turn is one or more
+// sowings, each one after a sowing whose last bean landed in the player's own pot; a sowing ending
+// in an empty hole of the player's with beans opposite captures them; and a game that has ended
+// (one side's holes are empty, so the rest of the beans are swept into the pots) has no turns
+// after it, so a game ending before the depth is reached adds nothing, while one ending on the
+// last turn is a leaf like any other. Unlike a TurnList, perft counts turns that leave the same
+// position separately, since it's checking every path the rules allow.
+//
+// The counts check that moves are generated correctly (they are fixed for a given position and
+// depth, so a wrong one shows a bug), and the time taken measures how fast they are generated.
+//==========================================================================
+
+struct PerftTurn
+{
+    std::vector<int> m_holes; // the holes sown, in order
+    std::uint64_t m_leaves; // the leaves below the position the turn leaves
+};
+
+std::uint64_t perft(const Board& b, Side s, int depth, int threads = 1,
+                    std::vector<PerftTurn>* divide = nullptr);
+    // Return the number of sequences of depth complete turns that can be played from position b
+    // with s to move (1 if depth is 0). The turns at the top are divided among threads threads
+    // (one per processor core if threads isn't positive). If divide isn't null, set it to every
+    // turn s can take, in order of their holes, with the leaves below each (which add up to
+    // the number returned).
+
+#endif /* Perft_h */
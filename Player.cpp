@@ -1,7 +1,42 @@
 #include <string>
 #include "Player.h"
+#include "BoardT.h"
+#include "Search.h"
+#include "Mcts.h"
+#include <type_traits>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <iostream>
 
+MoveRequest::MoveRequest(std::function<void(int)> done)
+// Create a request that calls done (unless it's null) with the hole chosen.
+: m_cancelled(false), m_completed(false), m_done(done)
+{
+}
+
+std::future<int> MoveRequest::future()
+// Return a future that becomes ready with the hole chosen. Call this at most once.
+{
+    return m_hole.get_future();
+}
+
+bool MoveRequest::complete(int hole)
+// If the request hasn't been completed yet, complete it with the indicated hole and return
+// true; otherwise, do nothing and return false.
+{
+    if (m_completed.exchange(true)) // someone else got here first
+        return false;
+    m_hole.set_value(hole);
+    if (m_done)
+        m_done(hole);
+    return true;
+}
+
 Player::Player(std::string name)
 // Create a Player with the indicated name.
 {
@@ -21,6 +56,33 @@ bool Player::isInteractive() const
     return false; // computer player
 }
 
+int Player::chooseMoveUntil(const Board& b, Side s, const std::atomic<bool>& stop) const
+// Return the move chooseMove would, but stop thinking as soon as stop becomes true and
+// return the best move found so far (which may be -1 if none was). Players that think for
+// a while override this; by default it just calls chooseMove.
+{
+    (void)stop;
+    return chooseMove(b, s);
+}
+
+void Player::chooseMoveAsync(const Board& b, Side s, ThreadPool& pool,
+                             std::shared_ptr<MoveRequest> request) const
+// Start choosing the move for side s on a copy of board b and return at once; complete
+// request with the move once it's chosen. By default, a thread of pool calls
+// chooseMoveUntil, stopping when the request is cancelled.
+{
+    pool.submit([this, b, s, request]() {
+        request->complete(chooseMoveUntil(b, s, request->cancelFlag()));
+    });
+}
+
+void Player::stopPondering()
+// Stop any thinking the player is doing in the background on the opponent's time. A Game
+// calls this for both players when the game ends. Most kinds of players never ponder, so
+// by default this does nothing.
+{
+}
+
 Player::~Player()
 // Since this class is designed as a base class, it should have a virtual destructor.
 {
@@ -75,118 +137,484 @@ int BadPlayer::chooseMove(const Board& b, Side s) const
     return -1; // no possible moves
 }
 
-SmartPlayer::SmartPlayer(std::string name) : Player(name)
-// Create a HumanPlayer with the indicated name.
+RemotePlayer::RemotePlayer(std::string name) : Player(name), m_board(1, 0), m_side(SOUTH)
+// Create a RemotePlayer with the indicated name: a person whose moves come from outside the
+// program (over a network, say) through submitMove, so no thread waits while they think.
 {
 }
 
+bool RemotePlayer::isInteractive() const
+// Returns true bc the moves are a person's
+{
+    return true;
+}
+
+int RemotePlayer::chooseMove(const Board& b, Side s) const
+// Wait until a move is submitted, and return it. If no move is possible, return −1.
+{
+    std::shared_ptr<MoveRequest> request = std::make_shared<MoveRequest>();
+    std::future<int> hole = request->future();
+    expect(b, s, request);
+    return hole.get();
+}
+
+void RemotePlayer::chooseMoveAsync(const Board& b, Side s, ThreadPool& pool,
+                                   std::shared_ptr<MoveRequest> request) const
+// Remember the request and return at once; submitMove completes it. If no move is possible,
+// complete it with −1 right away.
+{
+    (void)pool; // nothing to run; the move comes from outside
+    expect(b, s, request);
+}
+
+bool RemotePlayer::waiting(Board& b, Side& s) const
+// If the player is waiting for a move, set b and s to the position and side it's for and
+// return true; otherwise, return false.
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_request == nullptr || m_request->completed())
+        return false;
+    b = m_board;
+    s = m_side;
+    return true;
+}
+
+bool RemotePlayer::submitMove(int hole)
+// If the player is waiting for a move and the indicated hole is a legal one, make it the
+// player's move and return true; otherwise, return false.
+{
+    std::shared_ptr<MoveRequest> request;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_request == nullptr || hole < 1 || hole > m_board.holes()
+            || m_board.beans(m_side, hole) == 0)
+            return false;
+        request.swap(m_request);
+    }
+    // complete it without holding the lock, since whoever made the request may ask for the next
+    // move from its callback
+    return request->complete(hole);
+}
+
+//////////
+
+void RemotePlayer::expect(const Board& b, Side s, std::shared_ptr<MoveRequest> request) const
+{
+    if (b.beansInPlay(s) == 0)
+    {
+        request->complete(-1);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_request = request;
+    m_board = b;
+    m_side = s;
+}
+
+struct SmartPlayer::Ponder
+{
+    // A search, run on the player's thread pool, of a position the player expects to face.
+    Ponder(const Board& b, Side s)
+    : m_board(b), m_side(s), m_stop(false), m_done(false), m_bestHole(-1),
+      m_start(std::chrono::steady_clock::now())
+    {
+    }
+    Board m_board; // the position being searched, with m_side to move
+    Side m_side;
+    std::atomic<bool> m_stop; // set to stop the search
+    std::mutex m_mutex; // guards m_done
+    std::condition_variable m_finished; // signaled when m_done is set
+    bool m_done; // the search is over
+    std::atomic<int> m_bestHole; // best move of the deepest depth finished, or -1
+    SearchStats m_stats; // what the search did, once m_done is set
+    std::chrono::steady_clock::time_point m_start; // when the search started
+    void wait()
+    // Wait until the search is over.
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this]() { return m_done; });
+    }
+};
+
+SmartPlayer::SmartPlayer(std::string name, int msPerMove, int maxDepth, int tableMegabytes, int threads)
+: Player(name), m_pool(threads), m_table(tableMegabytes), m_pondering(false), m_statsLog(nullptr)
+// Create a SmartPlayer with the indicated name that spends at most msPerMove milliseconds and
+// searches at most maxDepth turns deep to choose each move. A limit that isn't positive means
+// no limit of that kind; if neither limit is positive, act as if msPerMove were 4900. The
+// player's transposition table uses about tableMegabytes megabytes (at least 64 bytes). The
+// search runs on the indicated number of threads; if threads isn't positive, it uses one per
+// processor core.
+{
+    m_msPerMove = (msPerMove > 0 ? msPerMove : 0);
+    m_maxDepth = (maxDepth > 0 ? maxDepth : 0);
+    if (m_msPerMove == 0 && m_maxDepth == 0)
+        m_msPerMove = 4900;
+    m_maxNodes = 0;
+    m_threads = m_pool.size();
+}
+
+void SmartPlayer::setNodeLimit(long nodes)
+// Visit at most the indicated number of positions (in each search thread) to choose each move,
+// on top of the other limits, or no such limit if nodes isn't positive.
+{
+    m_maxNodes = (nodes > 0 ? nodes : 0);
+}
+
+bool SmartPlayer::useEndgameDatabase(const std::string& path)
+// Memory-map the endgame database in the indicated file (made by tools/makeendgame.cpp) and
+// look up positions in it from now on, so endgames it covers are played perfectly without
+// searching them. Return false (and use no database) if the file isn't a valid database.
+{
+    return m_endgame.open(path);
+}
+
+bool SmartPlayer::useOpeningBook(const std::string& path)
+// Read the opening book in the indicated file (made by tools/makebook.cpp) and play its move,
+// without searching, in every position it has. Return false (and use no book) if the file
+// isn't a valid book.
+{
+    return m_book.open(path);
+}
+
+void SmartPlayer::setPondering(bool on)
+// Turn pondering on or off (it's off to begin with). A pondering player, after choosing a move,
+// guesses the opponent's reply and keeps searching the position it expects to face next in a
+// background thread until it is next asked for a move. If the guess was right, chooseMove
+// uses that search, returning at once if it has already had the time a move is allowed;
+// either way the transposition table keeps what was found.
+{
+    m_pondering = on;
+    if (!on)
+        stopPondering();
+}
+
+void SmartPlayer::stopPondering()
+// Stop the background search, if there is one.
+{
+    if (m_ponder == nullptr)
+        return;
+    m_ponder->m_stop = true;
+    m_ponder->wait();
+    m_ponder.reset();
+}
+
+const SearchStats& SmartPlayer::lastStats() const
+// Return what the search did to choose the last move (see SearchStats.h).
+{
+    return m_stats;
+}
+
+void SmartPlayer::setStatsLog(std::ostream* log)
+// If log isn't null, write a line to it for every move chosen from now on, with the player's
+// name and the move's SearchStats; otherwise, stop writing them.
+{
+    m_statsLog = log;
+}
+
+SmartPlayer::~SmartPlayer()
+// Stop pondering.
+{
+    stopPondering();
+}
+
 int SmartPlayer::chooseMove(const Board& b, Side s) const
 // Every concrete class derived from this class must implement this function so that if the
 // player were to be playing side s and had to make a move given board b, the function returns
 // the move the player would choose. If no move is possible, return −1.
 {
-    if (b.beansInPlay(s) == 0) // no move is possible; game is finished
-        return -1;
-    int bestHole;
-    int value = 10; // arbitrary starting value
-    AlarmClock ac(4900);
-    minimax(b, s, bestHole, value, ac);
-    return bestHole;
+    return choose(b, s, nullptr);
+}
+
+int SmartPlayer::chooseMoveUntil(const Board& b, Side s, const std::atomic<bool>& stop) const
+// Return the move chooseMove would, but stop searching as soon as stop becomes true and
+// return the best move found so far.
+{
+    return choose(b, s, &stop);
 }
 
-void SmartPlayer::minimax(const Board& b, const Side& s, int& bestHole, int& value, AlarmClock& ac) const
-// assists with chooseMove
+//////////
+
+int SmartPlayer::choose(const Board& b, Side s, const std::atomic<bool>* stop) const
 {
-    // high value: good for south player, low value: good for north player
-    // if game over
-    Side initial_player;
-    if (value == 10) // very first call of the function
-        initial_player = s;
-    if (b.beansInPlay(s) == 0 || b.beansInPlay(opponent(s)) == 0)
+    // stop any search on the opponent's time; if it was searching this very position, it has
+    // done (some of) the work already
+    int bestHole = finishPondering(b, s, stop); // sets m_stats on a ponder hit
+    if (bestHole == -1)
+        m_stats.clear();
+    if (b.beansInPlay(s) == 0) // no move is possible; game is finished
+        return -1;
+    // a position in the opening book has already been searched, more deeply than there's time for
+    int bookHole;
+    if (m_book.lookup(b, s, bookHole) && b.beans(s, bookHole) > 0)
     {
-        // value = value of this position (i.e., +∞, -∞, or 0)
-        if (b.beansInPlay(SOUTH) + b.beans(SOUTH, 0) > b.beansInPlay(NORTH) + b.beans(NORTH, 0)) // south player won
-            value = 1000000;
-        else if (b.beansInPlay(SOUTH) + b.beans(SOUTH, 0) < b.beansInPlay(NORTH) + b.beans(NORTH, 0)) // north player won
-            value = -1000000;
-        else // tie
-            value = 0;
-        return;
+        bestHole = bookHole;
+        m_stats.clear();
+        m_stats.m_fromBook = true;
     }
-    // if the criterion says we should not search below this node
-    if (ac.timedOut())
+    else if (bestHole == -1)
     {
-        // value = value of this position
-        // see if it's impossible for one of the sides to win
-            // if the difference between the pots is > remaining beans in all holes
-        if (abs(b.beans(s, 0) - b.beans(opponent(s), 0)) > (b.beansInPlay(s) + b.beansInPlay(opponent(s))))
+        SearchLimits limits;
+        limits.setTime(m_msPerMove);
+        limits.setDepth(m_maxDepth);
+        limits.setNodes(m_maxNodes);
+        limits.setStop(stop);
+        bestHole = think(b, s, limits, nullptr, m_stats);
+    }
+    if (bestHole == -1) // no time to search at all; take the first legal move
+        for (int i = 1; i <= b.holes() && bestHole == -1; i++)
+            if (b.beans(s, i) > 0)
+                bestHole = i;
+    m_stats.m_bestHole = bestHole;
+    if (m_statsLog != nullptr)
+        *m_statsLog << name() << ": " << m_stats << std::endl;
+    if (m_pondering && (stop == nullptr || !*stop))
+        startPondering(b, s, bestHole);
+    return bestHole;
+}
+
+int SmartPlayer::think(const Board& b, Side s, const SearchLimits& limits, std::atomic<int>* deepest,
+                       SearchStats& stats) const
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    stats.clear();
+    int bestHole = -1;
+    int maxDepth = limits.depth();
+    m_table.newSearch();
+    // search a copy of b, in the fixed-size representation if there is one for this many holes;
+    // it's the one board the whole search makes and unmakes its moves on
+    withBoard(b, [&](auto& board) {
+        typedef typename std::decay<decltype(board)>::type B;
+        // Lazy SMP: helper searches, run on the player's thread pool, do the same iterative
+        // deepening on their own copies of the board, sharing the transposition table, so each
+        // thread finds many positions already searched by the others. Odd-numbered helpers start
+        // one turn deeper than the rest, so the threads don't all search the same depth at the
+        // same time. Only this thread's result is used; the helpers stop as soon as it's done.
+        const EndgameDatabase* endgame = (m_endgame.isOpen() ? &m_endgame : nullptr);
+        std::atomic<bool> helpersStop(false);
+        SearchLimits helperLimits(limits);
+        helperLimits.setStop(&helpersStop);
+        std::vector<B> copies(m_threads - 1, board);
+        std::vector<SearchStats> helperStats(m_threads - 1);
+        // this may itself be running on the pool (when pondering), so wait for just the helpers
+        // rather than for every task in the pool
+        std::mutex helpersMutex;
+        std::condition_variable helpersDone;
+        int helpersRunning = m_threads - 1;
+        for (int t = 1; t < m_threads; t++)
+            m_pool.submit([&, t]() {
+                Search<B> helper(copies[t - 1], helperLimits, &m_table, endgame);
+                for (int depth = 1 + t % 2; depth <= maxDepth; depth++)
+                {
+                    int hole;
+                    helper.searchRoot(s, depth, hole);
+                    if (helper.aborted() || helper.complete())
+                        break;
+                }
+                helper.addStats(helperStats[t - 1]);
+                std::lock_guard<std::mutex> lock(helpersMutex);
+                if (--helpersRunning == 0)
+                    helpersDone.notify_all();
+            });
+        Search<B> search(board, limits, &m_table, endgame);
+        // iterative deepening: search 1, 2, 3, ... turns deep, keeping the best move of the
+        // deepest search that finished, until time runs out or a deeper search can't change it
+        for (int depth = 1; depth <= maxDepth; depth++)
         {
-            // if south player can't win
-            if (b.beans(SOUTH, 0) < b.beans(NORTH, 0))
-                value = -1000000;
-            else // north player can't win
-                value = 1000000;
+            int hole;
+            int value = search.searchRoot(s, depth, hole);
+            if (search.aborted())
+            {
+                if (bestHole == -1) // didn't even finish depth 1; take the best move seen
+                    bestHole = hole;
+                break;
+            }
+            bestHole = hole;
+            stats.m_value = value;
+            stats.m_depth = depth;
+            if (deepest != nullptr)
+                *deepest = hole;
+            if (search.complete())
+                break;
         }
-        // south player's pot beans - north player's pot beans
-        else
+        helpersStop = true;
         {
-            value = (b.beans(SOUTH, 0) - b.beans(NORTH, 0));
+            std::unique_lock<std::mutex> lock(helpersMutex);
+            helpersDone.wait(lock, [&]() { return helpersRunning == 0; });
         }
+        for (size_t i = 0; i < helperStats.size(); i++)
+        {
+            stats.m_nodes += helperStats[i].m_nodes;
+            stats.m_cutoffs += helperStats[i].m_cutoffs;
+            stats.m_tableProbes += helperStats[i].m_tableProbes;
+            stats.m_tableHits += helperStats[i].m_tableHits;
+            stats.m_selDepth = std::max(stats.m_selDepth, helperStats[i].m_selDepth);
+        }
+        search.addStats(stats);
+        search.principalVariation(s, stats.m_depth, stats.m_pv);
+        stats.m_rootScores = search.rootScores();
+    });
+    stats.m_bestHole = bestHole;
+    stats.m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return bestHole;
+}
+
+void SmartPlayer::startPondering(const Board& b, Side s, int hole) const
+{
+    Board next(b);
+    Board::Undo undo;
+    next.makeMove(s, hole, undo);
+    if (undo.extraTurn()) // s moves again right away; there's no time to ponder
         return;
+    // guess the opponent's reply (more than one sowing if it earns extra turns): the best move the
+    // transposition table remembers for them. If there's none, ponder the position with them to
+    // move, which at least fills the table with results about every reply.
+    Side toMove = opponent(s);
+    while (toMove != s && next.beansInPlay(SOUTH) > 0 && next.beansInPlay(NORTH) > 0)
+    {
+        int depth, value, reply;
+        TranspositionTable::Bound bound;
+        if (!m_table.probe(positionKey(next, toMove), depth, bound, value, reply) || reply == 0
+            || next.beans(toMove, reply) <= 0)
+            break;
+        next.makeMove(toMove, reply, undo);
+        if (!undo.extraTurn())
+            toMove = s;
     }
-    // for every hole h the player can choose
-    for (int i = 0; i < b.holes(); i++)
+    int bookHole;
+    if (next.beansInPlay(SOUTH) == 0 || next.beansInPlay(NORTH) == 0 // game over
+        || (toMove == s && m_book.lookup(next, s, bookHole))) // answered without searching
+        return;
+    m_ponder.reset(new Ponder(next, toMove));
+    Ponder* p = m_ponder.get();
+    m_pool.submit([this, p]() {
+        SearchLimits limits; // no time limit; runs until stopped
+        limits.setDepth(m_maxDepth);
+        limits.setStop(&p->m_stop);
+        think(p->m_board, p->m_side, limits, &p->m_bestHole, p->m_stats);
+        // signal while holding the lock: once m_done is seen, the Ponder may be destroyed
+        std::lock_guard<std::mutex> lock(p->m_mutex);
+        p->m_done = true;
+        p->m_finished.notify_all();
+    });
+}
+
+int SmartPlayer::finishPondering(const Board& b, Side s, const std::atomic<bool>* stop) const
+{
+    if (m_ponder == nullptr)
+        return -1;
+    Ponder* p = m_ponder.get();
+    bool hit = (p->m_side == s && p->m_board.holes() == b.holes());
+    for (int hole = 0; hole <= b.holes() && hit; hole++)
+        hit = (p->m_board.beans(SOUTH, hole) == b.beans(SOUTH, hole)
+               && p->m_board.beans(NORTH, hole) == b.beans(NORTH, hole));
+    if (hit) // the search under way is the one to do; give it the rest of this move's time
     {
-        if (b.beans(s, i + 1) > 0) // hole has a bean, can choose
+        // the search signals when it's done, but a stop flag can't, so while there is one, wake
+        // up every few milliseconds to look at it
+        const std::chrono::milliseconds stopCheck(5);
+        std::chrono::steady_clock::time_point deadline =
+            p->m_start + std::chrono::milliseconds(m_msPerMove);
+        std::unique_lock<std::mutex> lock(p->m_mutex);
+        while (!p->m_done && (stop == nullptr || !*stop))
         {
-            Side endside; int endHole;
-            // "make" the move h
-            Board copy = b; // set this to the board with the initial position
-            Board perform = b;
-            perform.sow(s, i + 1, endside, endHole);
-            // If it was placed in the player's pot, he must take another turn
-            if (endside == s && endHole == 0)
-            {
-                int value1 = 10;
-                minimax(perform, s, bestHole, value1, ac);
-                perform.sow(s, bestHole, endside, endHole);
-            }
-            // If capture occurred
-            // placed in one of the player's own holes that was empty just a moment before
-            // and if the opponent's hole directly opposite from that hole is not empty
-            if (endside == s && endHole > 0 && perform.beans(endside, endHole) == 1
-                && perform.beans(opponent(s), endHole) > 0)
-            {
-                // that bean and all beans in the opponent's hole directly opposite from that hole are put into the players pot
-                perform.moveToPot(s, endHole, s);
-                perform.moveToPot(opponent(s), endHole, s);
-            }
-            int bestHole1; int value1;
-            Side nextturn = opponent(s);
-            minimax(perform, nextturn, bestHole1, value1, ac);
-            perform = copy; // "unmake" the move
-            // set value to the first pathway value
-            if (value == 10)
-                value = value1;
-            if (initial_player == SOUTH) // want the highest value
-            {
-                if (value1 >= value)
-                {
-                    bestHole = i + 1;
-                    value = value1;
-                }
-            }
-            else // want the lowest value
-            {
-                if (value1 <= value)
-                {
-                    bestHole = i + 1;
-                    value = value1;
-                }
-            }
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (m_msPerMove != 0 && now >= deadline)
+                break;
+            if (stop != nullptr && (m_msPerMove == 0 || now + stopCheck < deadline))
+                p->m_finished.wait_until(lock, now + stopCheck);
+            else if (m_msPerMove != 0)
+                p->m_finished.wait_until(lock, deadline);
+            else // limited by depth only; the search will finish
+                p->m_finished.wait(lock);
         }
     }
-    return;
-} 
+    p->m_stop = true;
+    p->wait();
+    int bestHole = (hit ? p->m_bestHole.load() : -1);
+    if (bestHole != -1)
+    {
+        m_stats = p->m_stats;
+        m_stats.m_ponderHit = true;
+    }
+    m_ponder.reset();
+    return bestHole;
+}
+
+MctsPlayer::MctsPlayer(std::string name, int msPerMove, long playouts, int threads, int maxNodes)
+: Player(name), m_pool(threads), m_arenas(m_pool.size()), m_moves(0)
+// Create an MctsPlayer with the indicated name that chooses each move by Monte Carlo tree
+// search (see Mcts.h), spending at most msPerMove milliseconds and playing at most playouts
+// games out. A limit that isn't positive means no limit of that kind; if neither limit is
+// positive, act as if msPerMove were 4900. The search runs on the indicated number of threads,
+// or one per processor core if threads isn't positive, each growing its own tree of at most
+// maxNodes nodes.
+{
+    m_msPerMove = (msPerMove > 0 ? msPerMove : 0);
+    m_playouts = (playouts > 0 ? playouts : 0);
+    if (m_msPerMove == 0 && m_playouts == 0)
+        m_msPerMove = 4900;
+    m_maxNodes = (maxNodes > 1 ? maxNodes : 1);
+}
+
+MctsPlayer::~MctsPlayer()
+{
+}
+
+int MctsPlayer::chooseMove(const Board& b, Side s) const
+// Every concrete class derived from this class must implement this function so that if the
+// player were to be playing side s and had to make a move given board b, the function returns
+// the move the player would choose. If no move is possible, return −1.
+{
+    return choose(b, s, nullptr);
+}
 
+int MctsPlayer::chooseMoveUntil(const Board& b, Side s, const std::atomic<bool>& stop) const
+// Return the move chooseMove would, but stop playing games out as soon as stop becomes true
+// and choose from the ones played so far.
+{
+    return choose(b, s, &stop);
+}
 
+//////////
+
+int MctsPlayer::choose(const Board& b, Side s, const std::atomic<bool>* stop) const
+{
+    int nMoves = 0, onlyMove = -1;
+    for (int i = 1; i <= b.holes(); i++)
+        if (b.beans(s, i) > 0)
+        {
+            nMoves++;
+            onlyMove = i;
+        }
+    if (nMoves <= 1) // no move is possible (-1), or there's no choice to make
+        return onlyMove;
+    SearchLimits limits;
+    limits.setTime(m_msPerMove);
+    limits.setStop(stop);
+    std::atomic<long> budget(m_playouts);
+    std::vector<long> visits(b.holes() + 1, 0);
+    std::vector<double> rewards(b.holes() + 1, 0);
+    std::mutex statsMutex;
+    m_moves++;
+    // every thread grows its own tree from its own copy of b, in the fixed-size representation if
+    // there is one for this many holes, and adds its statistics for the root's moves to the totals
+    for (int t = 0; t < m_pool.size(); t++)
+        m_pool.submit([&, t]() {
+            withBoard(b, [&](auto& board) {
+                Mcts<typename std::decay<decltype(board)>::type> mcts(board, m_arenas[t], m_moves << 8 | t);
+                mcts.run(s, limits, m_playouts > 0 ? &budget : nullptr, m_maxNodes);
+                std::lock_guard<std::mutex> lock(statsMutex);
+                mcts.rootStats(visits, rewards);
+            });
+        });
+    m_pool.wait();
+    // the move played out most often is the one the search found best; ties go to the better
+    // average result
+    int bestHole = onlyMove;
+    for (int i = 1; i <= b.holes(); i++)
+        if (visits[i] > visits[bestHole]
+            || (visits[i] == visits[bestHole] && visits[i] > 0
+                && rewards[i] / visits[i] > rewards[bestHole] / visits[bestHole]))
+            bestHole = i;
+    return bestHole;
+}
@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <future>
+#include <thread>
 #include <atomic>
 
 class AlarmClock
@@ -46,9 +47,56 @@ private:
 }; 
 
 ////////
+#include <memory>
 #include <string>
 #include "Board.h"
 #include "Side.h"
+#include "TranspositionTable.h"
+#include "EndgameDatabase.h"
+#include "OpeningBook.h"
+#include "ThreadPool.h"
+#include "SearchLimits.h"
+#include "SearchStats.h"
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+//==========================================================================
+// A MoveRequest is one request for a player to choose a move without making the caller wait for
+// it (see Player::chooseMoveAsync). The player completes it with the hole it chooses, which calls
+// the callback it was made with (on whatever thread the player completes it on) and makes the hole
+// the value of its future. Only the first completion counts. Whoever made the request can cancel
+// it: the player then stops thinking as soon as it can and completes it with whatever move it has
+// (or -1), which the canceller will usually ignore.
+//==========================================================================
+
+class MoveRequest
+{
+public:
+    explicit MoveRequest(std::function<void(int)> done = nullptr);
+        // Create a request that calls done (unless it's null) with the hole chosen.
+    MoveRequest(const MoveRequest&) = delete;
+    MoveRequest& operator=(const MoveRequest&) = delete;
+    std::future<int> future();
+        // Return a future that becomes ready with the hole chosen. Call this at most once.
+    bool complete(int hole);
+        // If the request hasn't been completed yet, complete it with the indicated hole and return
+        // true; otherwise, do nothing and return false.
+    bool completed() const { return m_completed; }
+        // Return true if the request has been completed.
+    void cancel() { m_cancelled = true; }
+        // Tell the player to stop thinking and complete the request as soon as it can.
+    bool cancelled() const { return m_cancelled; }
+        // Return true if the request has been cancelled.
+    const std::atomic<bool>& cancelFlag() const { return m_cancelled; }
+        // Return the flag that becomes true when the request is cancelled (for a SearchLimits).
+private:
+    std::atomic<bool> m_cancelled;
+    std::atomic<bool> m_completed;
+    std::function<void(int)> m_done;
+    std::promise<int> m_hole;
+};
 
 class Player {
 public:
@@ -63,6 +111,21 @@ public:
         // Every concrete class derived from this class must implement this function so that if the
         // player were to be playing side s and had to make a move given board b, the function returns
         // the move the player would choose. If no move is possible, return −1.
+    virtual int chooseMoveUntil(const Board& b, Side s, const std::atomic<bool>& stop) const;
+        // Return the move chooseMove would, but stop thinking as soon as stop becomes true and
+        // return the best move found so far (which may be -1 if none was). Players that think for
+        // a while override this; by default it just calls chooseMove.
+    virtual void chooseMoveAsync(const Board& b, Side s, ThreadPool& pool,
+                                 std::shared_ptr<MoveRequest> request) const;
+        // Start choosing the move for side s on a copy of board b and return at once; complete
+        // request with the move once it's chosen. By default, a thread of pool calls
+        // chooseMoveUntil, stopping when the request is cancelled, so only players that choose
+        // their moves some other way (like a RemotePlayer) override this. The player must not be
+        // asked for another move until this request is completed.
+    virtual void stopPondering();
+        // Stop any thinking the player is doing in the background on the opponent's time. A Game
+        // calls this for both players when the game ends. Most kinds of players never ponder, so
+        // by default this does nothing.
     virtual ~Player();
         // Since this class is designed as a base class, it should have a virtual destructor.
 private:
@@ -90,16 +153,141 @@ public:
     // If no move is possible, return −1.
 };
 
+class RemotePlayer : public Player {
+public:
+    RemotePlayer(std::string name);
+    // Create a RemotePlayer with the indicated name: a person whose moves come from outside the
+    // program (over a network, say) through submitMove, so no thread waits while they think.
+    virtual bool isInteractive() const;
+    // Returns true bc the moves are a person's
+    virtual int chooseMove(const Board& b, Side s) const;
+    // Wait until a move is submitted, and return it. If no move is possible, return −1.
+    virtual void chooseMoveAsync(const Board& b, Side s, ThreadPool& pool,
+                                 std::shared_ptr<MoveRequest> request) const;
+    // Remember the request and return at once; submitMove completes it. If no move is possible,
+    // complete it with −1 right away.
+    bool waiting(Board& b, Side& s) const;
+    // If the player is waiting for a move, set b and s to the position and side it's for and
+    // return true; otherwise, return false.
+    bool submitMove(int hole);
+    // If the player is waiting for a move and the indicated hole is a legal one, make it the
+    // player's move and return true; otherwise, return false.
+private:
+    void expect(const Board& b, Side s, std::shared_ptr<MoveRequest> request) const;
+    // Make request the one waiting for a move for side s on board b, or complete it with −1 at
+    // once if s has no move.
+    mutable std::mutex m_mutex; // guards the members below
+    mutable std::shared_ptr<MoveRequest> m_request; // the request waiting for a move, or null
+    mutable Board m_board; // the position it's for
+    mutable Side m_side;
+};
+
 class SmartPlayer : public Player {
 public:
-    SmartPlayer(std::string name);
-    // Create a SmartPlayer with the indicated name.
+    SmartPlayer(std::string name, int msPerMove = 4900, int maxDepth = 0, int tableMegabytes = 16,
+                int threads = 1);
+    // Create a SmartPlayer with the indicated name that spends at most msPerMove milliseconds and
+    // searches at most maxDepth turns deep to choose each move. A limit that isn't positive means
+    // no limit of that kind; if neither limit is positive, act as if msPerMove were 4900. The
+    // player's transposition table uses about tableMegabytes megabytes (at least 64 bytes). The
+    // search runs on the indicated number of threads; if threads isn't positive, it uses one per
+    // processor core.
+    bool useEndgameDatabase(const std::string& path);
+    // Memory-map the endgame database in the indicated file (made by tools/makeendgame.cpp) and
+    // look up positions in it from now on, so endgames it covers are played perfectly without
+    // searching them. Return false (and use no database) if the file isn't a valid database.
+    void setNodeLimit(long nodes);
+    // Visit at most the indicated number of positions (in each search thread) to choose each move,
+    // on top of the other limits, or no such limit if nodes isn't positive.
+    void setPondering(bool on);
+    // Turn pondering on or off (it's off to begin with). A pondering player, after choosing a move,
+    // guesses the opponent's reply and keeps searching the position it expects to face next in a
+    // background thread until it is next asked for a move. If the guess was right, chooseMove
+    // uses that search, returning at once if it has already had the time a move is allowed;
+    // either way the transposition table keeps what was found.
+    virtual void stopPondering();
+    // Stop the background search, if there is one.
+    virtual ~SmartPlayer();
+    // Stop pondering.
+    bool useOpeningBook(const std::string& path);
+    // Read the opening book in the indicated file (made by tools/makebook.cpp) and play its move,
+    // without searching, in every position it has. Return false (and use no book) if the file
+    // isn't a valid book.
+    virtual int chooseMove(const Board& b, Side s) const;
+    // Every concrete class derived from this class must implement this function so that if the
+    // player were to be playing side s and had to make a move given board b, the function returns
+    // the move the player would choose. If no move is possible, return −1.
+    virtual int chooseMoveUntil(const Board& b, Side s, const std::atomic<bool>& stop) const;
+    // Return the move chooseMove would, but stop searching as soon as stop becomes true and
+    // return the best move found so far.
+    const SearchStats& lastStats() const;
+    // Return what the search did to choose the last move (see SearchStats.h).
+    void setStatsLog(std::ostream* log);
+    // If log isn't null, write a line to it for every move chosen from now on, with the player's
+    // name and the move's SearchStats; otherwise, stop writing them.
+private:
+    struct Ponder; // a background search on the opponent's time (see Player.cpp)
+    int choose(const Board& b, Side s, const std::atomic<bool>* stop) const;
+    // Choose the move for side s on board b, stopping as soon as *stop becomes true if stop isn't
+    // null.
+    int think(const Board& b, Side s, const SearchLimits& limits, std::atomic<int>* deepest,
+              SearchStats& stats) const;
+    // Search position b with s to move by iterative deepening, until limits are reached (by each
+    // thread's search, for the limit on positions) or searching deeper can't change the
+    // result. Return the best move of the deepest search that finished, or of the part of the
+    // first that did if none finished, or -1 if there wasn't time to find one. If deepest isn't
+    // null, store the best move in it as each depth finishes. Set stats to what the search did.
+    void startPondering(const Board& b, Side s, int hole) const;
+    // Start pondering the position expected after s makes move hole on board b.
+    int finishPondering(const Board& b, Side s, const std::atomic<bool>* stop) const;
+    // Stop pondering. If the position pondered was b with s to move, first let the search go on
+    // for the rest of the time a move is allowed (or until it's finished, or *stop becomes true
+    // if stop isn't null), then return its best
+    // move (and set m_stats to what it did); otherwise return -1.
+    int m_msPerMove; // time limit per move, or 0 for none
+    int m_maxDepth; // depth limit, or 0 for none
+    long m_maxNodes; // limit on positions visited per thread, or 0 for none
+    int m_threads; // number of threads to search with (at least 1)
+    mutable ThreadPool m_pool; // m_threads threads, started once, for helper and ponder searches
+    mutable TranspositionTable m_table; // search results, kept from one move to the next
+    EndgameDatabase m_endgame; // perfect play for positions with few beans left, if open
+    OpeningBook m_book; // moves for the first positions of a game, if open
+    bool m_pondering; // whether to ponder after choosing a move
+    mutable std::unique_ptr<Ponder> m_ponder; // the search on the opponent's time, if any
+    mutable SearchStats m_stats; // what the search for the last move did
+    std::ostream* m_statsLog; // where to write m_stats after each move, or null
+};
+
+struct MctsNode; // see Mcts.h
+
+class MctsPlayer : public Player {
+public:
+    MctsPlayer(std::string name, int msPerMove = 4900, long playouts = 0, int threads = 0,
+               int maxNodes = 1 << 20);
+    // Create an MctsPlayer with the indicated name that chooses each move by Monte Carlo tree
+    // search (see Mcts.h), spending at most msPerMove milliseconds and playing at most playouts
+    // games out. A limit that isn't positive means no limit of that kind; if neither limit is
+    // positive, act as if msPerMove were 4900. The search runs on the indicated number of threads,
+    // or one per processor core if threads isn't positive, each growing its own tree of at most
+    // maxNodes nodes.
+    virtual ~MctsPlayer();
     virtual int chooseMove(const Board& b, Side s) const;
     // Every concrete class derived from this class must implement this function so that if the
     // player were to be playing side s and had to make a move given board b, the function returns
     // the move the player would choose. If no move is possible, return −1.
+    virtual int chooseMoveUntil(const Board& b, Side s, const std::atomic<bool>& stop) const;
+    // Return the move chooseMove would, but stop playing games out as soon as stop becomes true
+    // and choose from the ones played so far.
 private:
-    void minimax(const Board& b, const Side& s, int& bestHole, int& value, AlarmClock& ac) const;
+    int choose(const Board& b, Side s, const std::atomic<bool>* stop) const;
+    // Choose the move for side s on board b, stopping as soon as *stop becomes true if stop isn't
+    // null.
+    int m_msPerMove; // time limit per move, or 0 for none
+    long m_playouts; // playout limit per move, or 0 for none
+    int m_maxNodes; // size limit of each thread's tree
+    mutable ThreadPool m_pool; // one thread per tree
+    mutable std::vector<std::vector<MctsNode> > m_arenas; // each thread's tree, kept for reuse
+    mutable std::uint64_t m_moves; // number of moves chosen, to vary the random numbers
 };
 
 #endif /* Player_h */
@@ -0,0 +1,450 @@
+#ifndef Search_h
+#define Search_h
+#include "Side.h"
+#include "SearchLimits.h"
+#include "BoardLayout.h"
+#include "TranspositionTable.h"
+#include "EndgameDatabase.h"
+#include "SearchStats.h"
+#include "Turns.h"
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+//==========================================================================
+// Search<B> is SmartPlayer's game-tree search: depth-limited minimax with alpha-beta pruning over
+// a board of type B (Board or one of the BoardT<N>). Values are from SOUTH's point of view (high
+// is good for SOUTH, low is good for NORTH), as described in report.txt. The tree branches on
+// whole turns (see Turns.h) rather than single sowings: a chain of sowings that earns extra turns
+// is one move, a turn that leaves the same position as another isn't searched twice, and the
+// depth counts turns, so a line with extra turns in it is searched as far ahead as any other.
+// Turns are tried in the order most likely to cause a cutoff: those starting with the best move
+// the transposition table remembers for the position, then the ones that put the most beans in
+// the mover's pot (extra turns and captures), then those starting with the killer moves that
+// caused cutoffs at the same ply elsewhere in the tree, then the rest by their first move's
+// history score. With a transposition table, positions already searched deeply enough (or to the
+// end of the game) aren't searched again, and positions in the endgame database have their exact
+// values looked up instead of searched. If the search's limits (on time, positions visited, or a
+// stop flag) are reached in the middle of a search, the search is abandoned (see aborted) rather
+// than finished with guesses, so callers doing iterative deepening can fall back on the result of
+// the last depth they completed. Several Searches, each with its own board, may share one
+// transposition table and run at the same time on different threads. Each Search counts what it
+// did (positions, cutoffs, table lookups, the deepest ply reached) for SearchStats.
+//==========================================================================
+
+const int WIN_VALUE = 1000000; // value of a position SOUTH has won (-WIN_VALUE: NORTH has won)
+
+template <class B>
+int evaluate(const B& b)
+// Return the value of position b for a search that stops there.
+{
+    int south = b.beansInPlay(SOUTH) + b.beans(SOUTH, POT);
+    int north = b.beansInPlay(NORTH) + b.beans(NORTH, POT);
+    // if game over, value = value of this position (i.e., +∞, -∞, or 0)
+    if (b.beansInPlay(SOUTH) == 0 || b.beansInPlay(NORTH) == 0)
+        return south > north ? WIN_VALUE : (south < north ? -WIN_VALUE : 0);
+    // see if it's impossible for one of the sides to win
+        // if the difference between the pots is > remaining beans in all holes
+    int potDiff = b.beans(SOUTH, POT) - b.beans(NORTH, POT);
+    if (abs(potDiff) > b.beansInPlay(SOUTH) + b.beansInPlay(NORTH))
+        return potDiff > 0 ? WIN_VALUE : -WIN_VALUE;
+    // south player's pot beans - north player's pot beans
+    return potDiff;
+}
+
+template <class B>
+class Search
+{
+public:
+    Search(B& b, const SearchLimits& limits, TranspositionTable* table = nullptr,
+           const EndgameDatabase* endgame = nullptr);
+        // Prepare to search position b (which is changed during a search, but restored by the end
+        // of it), giving up when limits are reached (counting the positions visited by every
+        // searchRoot call), using table (if not null) to remember results, and looking up
+        // positions in endgame (if not null). The depth limit is up to the caller.
+    int searchRoot(Side s, int depth, int& bestHole);
+        // Search the position with s to move to the indicated depth (in turns) and return its
+        // value. Set bestHole to the first sowing of the best turn; among equally good turns, it's
+        // the one starting with the highest numbered hole, which is the move plain minimax would
+        // pick. Turns starting with the best move of the previous call are searched first. If the
+        // search is aborted, bestHole is the best of the moves whose search finished, or -1 if
+        // there are none.
+    bool aborted() const { return m_aborted; }
+        // Return true if the last searchRoot call reached the limits before it finished.
+    bool complete() const { return !m_aborted && !m_hitDepth; }
+        // Return true if the last searchRoot call reached the end of the game on every line it
+        // searched, so searching deeper would give the same result.
+    long nodes() const { return m_nodes; }
+        // Return the number of positions visited so far.
+    void addStats(SearchStats& st) const;
+        // Add this search's counts so far (positions, cutoffs, table probes and hits) to st, and
+        // raise st.m_selDepth to the deepest ply it reached if that's deeper.
+    const std::vector<int>& rootScores() const { return m_lastRootScores; }
+        // Return the value of each move (indexed by hole) found by the last searchRoot call that
+        // wasn't aborted, the best of the turns starting with it (for moves other than the best,
+        // only a bound showing it's no better), or
+        // SearchStats::NO_SCORE for holes that aren't legal moves; empty if there's been no such
+        // call.
+    void principalVariation(Side s, int maxLength, std::vector<int>& pv);
+        // Set pv to the line of play expected from the position with s to move, starting with the
+        // best move of the last searchRoot call that wasn't aborted and following the best moves
+        // the transposition table remembers, for at most maxLength turns.
+private:
+    struct Ply
+    {
+        TurnList m_turns; // turns possible at this ply
+        std::vector<int> m_order; // indexes of m_turns, in the order to search them
+    };
+    static const int MAX_PLY = 128; // deepest ply killer moves are kept for
+    static const int INF = WIN_VALUE + 1; // bigger than any value
+    B& m_board;
+    const SearchLimits& m_limits;
+    TranspositionTable* m_table;
+    const EndgameDatabase* m_endgame;
+    std::uint64_t m_sizeKey; // hashed in so boards of different sizes don't share entries
+    long m_nodes;
+    long m_cutoffs; // times alphaBeta skipped the rest of the moves
+    long m_tableProbes; // transposition table lookups
+    long m_tableHits; // lookups that found the position
+    int m_selDepth; // deepest ply alphaBeta reached
+    bool m_aborted; // the limits were reached during the last searchRoot
+    bool m_hitDepth; // the last searchRoot stopped some line at its depth limit
+    int m_rootBest; // best move found by the last searchRoot, or 0
+    std::vector<int> m_rootScores; // value of each root move in the searchRoot under way
+    std::vector<int> m_lastRootScores; // value of each root move in the last one not aborted
+    int m_killers[MAX_PLY][2]; // first moves of the two most recent turns that caused a cutoff
+                               // at each ply
+    std::vector<int> m_history; // m_history[s * (holes + 1) + hole]: how often turns starting
+                                // with it caused cutoffs
+    std::deque<Ply> m_plies; // turn lists for each ply (a deque, so adding a ply doesn't move the
+                             // others)
+    std::vector<int> m_scores; // ordering scores of the turn list being sorted
+    std::vector<typename B::Undo> m_undos; // sowings made since the root, to take back
+    int alphaBeta(Side s, int depth, int ply, int alpha, int beta);
+    std::uint64_t key(Side s) const;
+        // Return the transposition table key of the position with s to move (the same as
+        // positionKey, with the size key computed once).
+    Ply& plyAt(int ply);
+        // Return the turn lists for the indicated ply.
+    int orderTurns(Side s, int ply, int hint);
+        // Generate the turns for s at the indicated ply, put them in order, best first (starting
+        // with those whose first move is hint), and return how many there are.
+    void store(Side s, const TurnList& turns, int best, int depth, TranspositionTable::Bound bound,
+               int value);
+        // Store the result of searching the position with s to move, whose best turn was
+        // turns[best], in the transposition table, along with the same result for each position
+        // partway through that turn.
+    void noteCutoff(Side s, int ply, int depth, int hole);
+        // Remember that a turn starting with hole caused a cutoff, for ordering turns later.
+};
+
+//////////
+
+template <class B>
+Search<B>::Search(B& b, const SearchLimits& limits, TranspositionTable* table,
+                  const EndgameDatabase* endgame)
+: m_board(b), m_limits(limits), m_table(table), m_endgame(endgame),
+  m_sizeKey(sizeKey(b.holes())), m_nodes(0), m_cutoffs(0), m_tableProbes(0), m_tableHits(0),
+  m_selDepth(0), m_aborted(false), m_hitDepth(false), m_rootBest(0)
+{
+    for (int ply = 0; ply < MAX_PLY; ply++)
+        m_killers[ply][0] = m_killers[ply][1] = 0;
+    m_history.assign(NSIDES * (b.holes() + 1), 0);
+}
+
+template <class B>
+int Search<B>::searchRoot(Side s, int depth, int& bestHole)
+{
+    m_aborted = false;
+    m_hitDepth = false;
+    Ply& p = plyAt(0);
+    int nTurns = orderTurns(s, 0, m_rootBest);
+    m_nodes++;
+    m_rootScores.assign(m_board.holes() + 1, SearchStats::NO_SCORE);
+    bestHole = -1;
+    int bestTurn = -1;
+    int value = 0;
+    for (int i = 0; i < nTurns; i++)
+    {
+        int t = p.m_order[i];
+        int hole = p.m_turns.hole(t, 0);
+        p.m_turns.make(m_board, s, t, m_undos);
+        // search later turns with a window one wider than the best value so far, so that a turn
+        // exactly as good comes back with its true value and the tie can be broken by hole number
+        int v;
+        if (bestTurn == -1)
+            v = alphaBeta(opponent(s), depth - 1, 1, -INF, INF);
+        else if (s == SOUTH)
+            v = alphaBeta(opponent(s), depth - 1, 1, value - 1, INF);
+        else
+            v = alphaBeta(opponent(s), depth - 1, 1, -INF, value + 1);
+        TurnList::unmake(m_board, p.m_turns[t], m_undos); // "unmake" the turn
+        if (m_aborted) // v is meaningless
+            break;
+        int& score = m_rootScores[hole];
+        if (score == SearchStats::NO_SCORE || (s == SOUTH ? v > score : v < score))
+            score = v;
+        bool better = (s == SOUTH ? v > value : v < value);
+        if (bestTurn == -1 || better || (v == value && hole > bestHole))
+        {
+            bestTurn = t;
+            bestHole = hole;
+            value = v;
+        }
+    }
+    if (!m_aborted)
+    {
+        m_rootBest = bestHole;
+        m_lastRootScores = m_rootScores;
+        if (m_table != nullptr && bestTurn != -1)
+            store(s, p.m_turns, bestTurn, m_hitDepth ? depth : TranspositionTable::COMPLETE,
+                  TranspositionTable::EXACT, value);
+    }
+    return value;
+}
+
+template <class B>
+int Search<B>::alphaBeta(Side s, int depth, int ply, int alpha, int beta)
+// Return the value of the position with s to move, searched depth more turns deep. If the true
+// value is at most alpha, the value returned is at most alpha; if it is at least beta, the value
+// returned is at least beta.
+{
+    m_nodes++;
+    if (ply > m_selDepth)
+        m_selDepth = ply;
+    // if the limits are reached (checked every so often, since reading the clock isn't free),
+    // give up on the whole search
+    if (m_aborted
+        || ((m_nodes & (SearchLimits::CHECK_INTERVAL - 1)) == 0 && m_limits.reached(m_nodes)))
+    {
+        m_aborted = true;
+        return 0;
+    }
+    // if game over, or the criterion says we should not search below this node
+    if (m_board.beansInPlay(SOUTH) == 0 || m_board.beansInPlay(NORTH) == 0)
+        return evaluate(m_board);
+    // if the endgame database knows how the rest of the game goes, that's the exact value
+    int margin;
+    if (m_endgame != nullptr && m_endgame->probe(m_board, s, margin))
+    {
+        int diff = m_board.beans(SOUTH, POT) - m_board.beans(NORTH, POT) + margin;
+        return diff > 0 ? WIN_VALUE : (diff < 0 ? -WIN_VALUE : 0);
+    }
+    if (depth <= 0)
+    {
+        m_hitDepth = true;
+        return evaluate(m_board);
+    }
+    // if this position has been searched deeply enough before, use that result
+    std::uint64_t k = 0;
+    int hint = 0;
+    if (m_table != nullptr)
+    {
+        k = key(s);
+        int d, v;
+        TranspositionTable::Bound bound;
+        m_tableProbes++;
+        bool found = m_table->probe(k, d, bound, v, hint);
+        if (found)
+            m_tableHits++;
+        if (found
+            && (d == TranspositionTable::COMPLETE || d >= depth)
+            && (bound == TranspositionTable::EXACT || (bound == TranspositionTable::LOWER && v >= beta)
+                || (bound == TranspositionTable::UPPER && v <= alpha)))
+        {
+            if (d != TranspositionTable::COMPLETE)
+                m_hitDepth = true;
+            return v;
+        }
+    }
+    const int alphaOrig = alpha, betaOrig = beta;
+    // find out whether this subtree stops any line at the depth limit, separately from the rest
+    bool hitBefore = m_hitDepth;
+    m_hitDepth = false;
+    Ply& p = plyAt(ply);
+    int nTurns = orderTurns(s, ply, hint);
+    int value = (s == SOUTH ? -INF : INF);
+    int bestTurn = -1;
+    for (int i = 0; i < nTurns; i++)
+    {
+        int t = p.m_order[i];
+        p.m_turns.make(m_board, s, t, m_undos);
+        int v = alphaBeta(opponent(s), depth - 1, ply + 1, alpha, beta);
+        TurnList::unmake(m_board, p.m_turns[t], m_undos);
+        if (m_aborted)
+            return 0;
+        if (s == SOUTH) // want the highest value
+        {
+            if (v > value)
+            {
+                value = v;
+                bestTurn = t;
+            }
+            if (value > alpha)
+                alpha = value;
+        }
+        else // want the lowest value
+        {
+            if (v < value)
+            {
+                value = v;
+                bestTurn = t;
+            }
+            if (value < beta)
+                beta = value;
+        }
+        if (alpha >= beta) // the other player won't allow this position; skip the other moves
+        {
+            m_cutoffs++;
+            noteCutoff(s, ply, depth, p.m_turns.hole(t, 0));
+            break;
+        }
+    }
+    bool hit = m_hitDepth;
+    m_hitDepth = hitBefore || hit;
+    if (m_table != nullptr)
+    {
+        TranspositionTable::Bound bound = TranspositionTable::EXACT;
+        if (value <= alphaOrig)
+            bound = TranspositionTable::UPPER;
+        else if (value >= betaOrig)
+            bound = TranspositionTable::LOWER;
+        store(s, p.m_turns, bestTurn, hit ? depth : TranspositionTable::COMPLETE, bound, value);
+    }
+    return value;
+}
+
+template <class B>
+void Search<B>::addStats(SearchStats& st) const
+{
+    st.m_nodes += m_nodes;
+    st.m_cutoffs += m_cutoffs;
+    st.m_tableProbes += m_tableProbes;
+    st.m_tableHits += m_tableHits;
+    if (m_selDepth > st.m_selDepth)
+        st.m_selDepth = m_selDepth;
+}
+
+template <class B>
+void Search<B>::principalVariation(Side s, int maxLength, std::vector<int>& pv)
+{
+    pv.clear();
+    std::vector<typename B::Undo> undos;
+    int hole = m_rootBest;
+    int turns = 0;
+    while (hole > 0 && turns < maxLength && m_board.beans(s, hole) > 0)
+    {
+        pv.push_back(hole);
+        typename B::Undo undo;
+        m_board.makeMove(s, hole, undo);
+        undos.push_back(undo);
+        if (!undo.extraTurn())
+        {
+            s = opponent(s);
+            turns++;
+        }
+        int d, v;
+        TranspositionTable::Bound bound;
+        if (m_table == nullptr || m_board.beansInPlay(SOUTH) == 0 || m_board.beansInPlay(NORTH) == 0
+            || !m_table->probe(key(s), d, bound, v, hole))
+            break;
+    }
+    while (!undos.empty()) // back to the position searched
+    {
+        m_board.unmakeMove(undos.back());
+        undos.pop_back();
+    }
+}
+
+template <class B>
+std::uint64_t Search<B>::key(Side s) const
+{
+    return m_board.hash() ^ m_sizeKey ^ (s == NORTH ? ZOBRIST.m_northToMove : 0);
+}
+
+template <class B>
+typename Search<B>::Ply& Search<B>::plyAt(int ply)
+{
+    while (ply >= static_cast<int>(m_plies.size()))
+        m_plies.push_back(Ply());
+    return m_plies[ply];
+}
+
+template <class B>
+int Search<B>::orderTurns(Side s, int ply, int hint)
+{
+    // score each turn; higher scores are tried first. Beans put in the pot count for the most, so
+    // extra turns and captures come before quiet moves.
+    const int HINT = 1 << 30, GAIN = 1 << 21, KILLER = 1 << 20, MAX_GAIN = 255;
+    Ply& p = plyAt(ply);
+    int n = p.m_turns.generate(m_board, s);
+    p.m_order.resize(n);
+    if (static_cast<int>(m_scores.size()) < n)
+        m_scores.resize(n);
+    int* order = p.m_order.data();
+    int* scores = m_scores.data();
+    for (int t = 0; t < n; t++)
+    {
+        int hole = p.m_turns.hole(t, 0);
+        int gain = p.m_turns[t].m_gain;
+        int score = (gain < MAX_GAIN ? gain : MAX_GAIN) * GAIN;
+        if (hole == hint)
+            score += HINT;
+        if (ply < MAX_PLY && (hole == m_killers[ply][0] || hole == m_killers[ply][1]))
+            score += (hole == m_killers[ply][0] ? KILLER + 1 : KILLER);
+        else
+            score += m_history[s * (m_board.holes() + 1) + hole];
+        // insertion sort, keeping equal scores in the order the turns were generated
+        int i = t;
+        for ( ; i > 0 && scores[i - 1] < score; i--)
+        {
+            scores[i] = scores[i - 1];
+            order[i] = order[i - 1];
+        }
+        scores[i] = score;
+        order[i] = t;
+    }
+    return n;
+}
+
+template <class B>
+void Search<B>::store(Side s, const TurnList& turns, int best, int depth,
+                      TranspositionTable::Bound bound, int value)
+{
+    // a position partway through the best turn has the same value if the value is exact, and the
+    // same bound holds for it if it's a bound: its turns are the rest of some of this position's,
+    // including the rest of the best one
+    const TurnList::Turn& turn = turns[best];
+    for (int k = 0; k < turn.m_length; k++)
+    {
+        m_table->store(key(s), depth, bound, value, turns.hole(best, k));
+        if (k == turn.m_length - 1)
+            break;
+        typename B::Undo undo;
+        m_board.makeMove(s, turns.hole(best, k), undo);
+        m_undos.push_back(undo);
+    }
+    for (int k = 0; k < turn.m_length - 1; k++)
+    {
+        m_board.unmakeMove(m_undos.back());
+        m_undos.pop_back();
+    }
+}
+
+template <class B>
+void Search<B>::noteCutoff(Side s, int ply, int depth, int hole)
+{
+    if (ply < MAX_PLY && m_killers[ply][0] != hole)
+    {
+        m_killers[ply][1] = m_killers[ply][0];
+        m_killers[ply][0] = hole;
+    }
+    int& h = m_history[s * (m_board.holes() + 1) + hole];
+    h += depth * depth;
+    if (h >= (1 << 20)) // keep history scores below the killer scores
+        for (size_t i = 0; i < m_history.size(); i++)
+            m_history[i] /= 2;
+}
+
+#endif /* Search_h */
@@ -0,0 +1,60 @@
+#ifndef SearchLimits_h
+#define SearchLimits_h
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+//==========================================================================
+// SearchLimits says when a search must stop: at a wall-clock deadline, after visiting a number of
+// positions, when another thread sets a stop flag, or (for searches that go one depth at a time)
+// at a depth. Any of them may be left unset. A search calls reached every CHECK_INTERVAL positions
+// or so; it reads the clock itself (a steady clock, so changes to the system time don't matter)
+// rather than relying on a timer thread, so limits cost nothing to set up and many searches can
+// run at once without a thread apiece.
+//==========================================================================
+
+class SearchLimits
+{
+public:
+    static const long CHECK_INTERVAL = 1024;
+        // How many positions a search should visit between calls to reached (a power of two).
+    SearchLimits() : m_hasDeadline(false), m_nodes(0), m_depth(0), m_stop(nullptr) {}
+        // Construct limits that never stop a search.
+    void setTime(int ms)
+        // If ms is positive, stop searches ms milliseconds from now; otherwise, have no deadline.
+    {
+        m_hasDeadline = (ms > 0);
+        m_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    }
+    void setDeadline(std::chrono::steady_clock::time_point deadline)
+        // Stop searches at the indicated time.
+    {
+        m_hasDeadline = true;
+        m_deadline = deadline;
+    }
+    void setNodes(long nodes) { m_nodes = (nodes > 0 ? nodes : 0); }
+        // If nodes is positive, stop a search once it has visited that many positions; otherwise,
+        // have no limit on positions.
+    void setDepth(int depth) { m_depth = (depth > 0 ? depth : 0); }
+        // If depth is positive, search at most that many turns deep; otherwise, have no limit on
+        // depth.
+    void setStop(const std::atomic<bool>* stop) { m_stop = stop; }
+        // If stop isn't null, stop searches as soon as *stop becomes true.
+    int depth() const { return m_depth > 0 ? m_depth : std::numeric_limits<int>::max(); }
+        // Return the deepest a search may go.
+    bool reached(long nodes) const
+        // Return true if a search that has visited the indicated number of positions must stop.
+    {
+        return (m_stop != nullptr && m_stop->load(std::memory_order_relaxed))
+            || (m_nodes > 0 && nodes >= m_nodes)
+            || (m_hasDeadline && std::chrono::steady_clock::now() >= m_deadline);
+    }
+private:
+    bool m_hasDeadline;
+    std::chrono::steady_clock::time_point m_deadline;
+    long m_nodes; // limit on positions, or 0 for none
+    int m_depth; // limit on depth, or 0 for none
+    const std::atomic<bool>* m_stop; // stop flag, or null for none
+};
+
+#endif /* SearchLimits_h */
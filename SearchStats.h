@@ -0,0 +1,81 @@
+#ifndef SearchStats_h
+#define SearchStats_h
+#include <ostream>
+#include <vector>
+
+//==========================================================================
+// SearchStats records what a SmartPlayer's search did to choose a move: how many positions it
+// visited (on every thread) and how fast, how deep it got, how often moves caused cutoffs and the
+// transposition table had the position, the line of play it expects (the principal variation), and
+// what it found each move at the root to be worth. SmartPlayer::lastStats returns the record for
+// the last move chosen, and SmartPlayer::setStatsLog has one line written for every move, in the
+// form operator<< writes.
+//==========================================================================
+
+struct SearchStats
+{
+    static constexpr int NO_SCORE = -2000000; // root score of a hole that isn't a legal move
+    SearchStats() { clear(); }
+    void clear()
+        // Reset to the record of a move chosen without searching.
+    {
+        m_bestHole = -1;
+        m_value = 0;
+        m_depth = 0;
+        m_selDepth = 0;
+        m_nodes = 0;
+        m_seconds = 0;
+        m_cutoffs = 0;
+        m_tableProbes = 0;
+        m_tableHits = 0;
+        m_fromBook = false;
+        m_ponderHit = false;
+        m_pv.clear();
+        m_rootScores.clear();
+    }
+    long nodesPerSecond() const
+        // Return the number of positions visited per second.
+        { return m_seconds > 0 ? static_cast<long>(m_nodes / m_seconds) : 0; }
+    double tableHitRate() const
+        // Return the fraction of transposition table probes that found the position.
+        { return m_tableProbes > 0 ? static_cast<double>(m_tableHits) / m_tableProbes : 0; }
+    int m_bestHole; // move chosen
+    int m_value; // value of the position found by the deepest search finished (see report.txt)
+    int m_depth; // deepest search finished, in turns
+    int m_selDepth; // deepest ply any thread's search reached
+    long m_nodes; // positions visited, by every thread
+    double m_seconds; // time spent searching (for a ponder hit, counted from when pondering began)
+    long m_cutoffs; // times a move was good enough that the rest weren't searched
+    long m_tableProbes; // transposition table lookups
+    long m_tableHits; // lookups that found the position
+    bool m_fromBook; // the move came from the opening book, so nothing was searched
+    bool m_ponderHit; // the search was done on the opponent's time
+    std::vector<int> m_pv; // expected line of play, starting with m_bestHole: the hole sown by
+                           // whoever is to move at each step (the same side after an extra turn)
+    std::vector<int> m_rootScores; // m_rootScores[hole]: value the deepest search finished found
+                                   // for that move (for moves other than the best, only a bound
+                                   // showing it's no better), or NO_SCORE; empty if none finished
+};
+
+inline std::ostream& operator<<(std::ostream& out, const SearchStats& st)
+// Write st on one line, as "name value" pairs.
+{
+    out << "move " << st.m_bestHole;
+    if (st.m_fromBook)
+        return out << " book";
+    out << " value " << st.m_value << " depth " << st.m_depth << " seldepth " << st.m_selDepth
+        << " nodes " << st.m_nodes << " time " << st.m_seconds << " nps " << st.nodesPerSecond()
+        << " cutoffs " << st.m_cutoffs << " tthits " << st.tableHitRate();
+    if (st.m_ponderHit)
+        out << " ponderhit";
+    out << " pv";
+    for (size_t i = 0; i < st.m_pv.size(); i++)
+        out << ' ' << st.m_pv[i];
+    out << " scores";
+    for (size_t hole = 1; hole < st.m_rootScores.size(); hole++)
+        if (st.m_rootScores[hole] != SearchStats::NO_SCORE)
+            out << ' ' << hole << ':' << st.m_rootScores[hole];
+    return out;
+}
+
+#endif /* SearchStats_h */
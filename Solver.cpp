@@ -0,0 +1,242 @@
+#include "Solver.h"
+#include "BoardT.h"
+#include "BoardLayout.h"
+#include "Turns.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+
+namespace {
+
+const long REPORT_INTERVAL = 1L << 24; // positions between progress reports (a power of two)
+
+// The search behind Solver: fail-soft alpha-beta on the final margin over a board of type B (Board
+// or one of the BoardT<N>), to the end of every line.
+template <class B>
+class MarginSearch
+{
+public:
+    MarginSearch(B& b, const SearchLimits& limits, TranspositionTable& table,
+                 const EndgameDatabase* endgame, std::ostream* progress);
+    int search(Side s, int ply, int alpha, int beta);
+        // Return the final margin of the position with s to move, with perfect play. If it is at
+        // most alpha, the value returned is at most alpha; if it is at least beta, the value
+        // returned is at least beta. If the limits are reached, return 0 and set aborted.
+    void rootMoves(Side s, int margin, std::vector<int>& moves);
+        // Set moves to the first sowings of every turn for s that achieves margin, the position's
+        // proven margin.
+    bool aborted() const { return m_aborted; }
+    long nodes() const { return m_nodes; }
+    double seconds() const
+        { return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count(); }
+private:
+    struct Ply
+    {
+        TurnList m_turns; // turns possible at this ply
+        std::vector<int> m_order; // indexes of m_turns, in the order to search them
+    };
+    B& m_board;
+    const SearchLimits& m_limits;
+    TranspositionTable& m_table;
+    const EndgameDatabase* m_endgame;
+    std::ostream* m_progress;
+    std::uint64_t m_sizeKey;
+    std::chrono::steady_clock::time_point m_start;
+    long m_nodes;
+    bool m_aborted;
+    std::deque<Ply> m_plies; // turn lists for each ply
+    std::vector<typename B::Undo> m_undos; // sowings made since the root, to take back
+    int orderTurns(Side s, int ply, int hint);
+        // Generate the turns for s at the indicated ply, put them in order (those starting with
+        // hint first, then by beans put in the pot) and return how many there are.
+};
+
+template <class B>
+MarginSearch<B>::MarginSearch(B& b, const SearchLimits& limits, TranspositionTable& table,
+                              const EndgameDatabase* endgame, std::ostream* progress)
+: m_board(b), m_limits(limits), m_table(table), m_endgame(endgame), m_progress(progress),
+  m_sizeKey(sizeKey(b.holes())), m_start(std::chrono::steady_clock::now()), m_nodes(0),
+  m_aborted(false)
+{
+}
+
+template <class B>
+int MarginSearch<B>::search(Side s, int ply, int alpha, int beta)
+{
+    m_nodes++;
+    if (m_aborted
+        || ((m_nodes & (SearchLimits::CHECK_INTERVAL - 1)) == 0 && m_limits.reached(m_nodes)))
+    {
+        m_aborted = true;
+        return 0;
+    }
+    if (m_progress != nullptr && (m_nodes & (REPORT_INTERVAL - 1)) == 0)
+    {
+        double t = seconds();
+        *m_progress << "  " << m_nodes << " positions in " << t << "s ("
+                    << static_cast<long>(m_nodes / t) << "/s)" << std::endl;
+    }
+    int potDiff = m_board.beans(SOUTH, POT) - m_board.beans(NORTH, POT);
+    int inPlayS = m_board.beansInPlay(SOUTH), inPlayN = m_board.beansInPlay(NORTH);
+    if (inPlayS == 0 || inPlayN == 0) // game over; each side gets the beans left on its side
+        return potDiff + inPlayS - inPlayN;
+    int margin;
+    if (m_endgame != nullptr && m_endgame->probe(m_board, s, margin))
+        return potDiff + margin;
+    // however the beans in play are split, the margin can't leave this range
+    int left = inPlayS + inPlayN;
+    if (potDiff - left >= beta)
+        return potDiff - left;
+    if (potDiff + left <= alpha)
+        return potDiff + left;
+    std::uint64_t k = m_board.hash() ^ m_sizeKey ^ (s == NORTH ? ZOBRIST.m_northToMove : 0);
+    int hint = 0;
+    int d, v;
+    TranspositionTable::Bound bound;
+    if (m_table.probe(k, d, bound, v, hint)
+        && (bound == TranspositionTable::EXACT || (bound == TranspositionTable::LOWER && v >= beta)
+            || (bound == TranspositionTable::UPPER && v <= alpha)))
+        return v;
+    const int alphaOrig = alpha, betaOrig = beta;
+    int nTurns = orderTurns(s, ply, hint);
+    Ply& p = m_plies[ply];
+    int value = (s == SOUTH ? -left - 1 : left + 1) + potDiff; // worse than any real margin
+    int bestHole = 0;
+    for (int i = 0; i < nTurns; i++)
+    {
+        int t = p.m_order[i];
+        p.m_turns.make(m_board, s, t, m_undos);
+        int v = search(opponent(s), ply + 1, alpha, beta);
+        TurnList::unmake(m_board, p.m_turns[t], m_undos);
+        if (m_aborted)
+            return 0;
+        if (s == SOUTH ? v > value : v < value)
+        {
+            value = v;
+            bestHole = p.m_turns.hole(t, 0);
+        }
+        if (s == SOUTH && value > alpha)
+            alpha = value;
+        else if (s == NORTH && value < beta)
+            beta = value;
+        if (alpha >= beta)
+            break;
+    }
+    bound = TranspositionTable::EXACT;
+    if (value <= alphaOrig)
+        bound = TranspositionTable::UPPER;
+    else if (value >= betaOrig)
+        bound = TranspositionTable::LOWER;
+    m_table.store(k, TranspositionTable::COMPLETE, bound, value, bestHole);
+    return value;
+}
+
+template <class B>
+void MarginSearch<B>::rootMoves(Side s, int margin, std::vector<int>& moves)
+{
+    // a turn achieves the margin if a null-window search around it shows it's at least as good
+    moves.clear();
+    int nTurns = orderTurns(s, 0, 0);
+    Ply& p = m_plies[0];
+    for (int t = 0; t < nTurns && !m_aborted; t++)
+    {
+        int hole = p.m_turns.hole(t, 0);
+        bool known = false;
+        for (size_t i = 0; i < moves.size(); i++)
+            known = known || moves[i] == hole;
+        if (known)
+            continue;
+        p.m_turns.make(m_board, s, t, m_undos);
+        bool optimal = (s == SOUTH ? search(NORTH, 1, margin - 1, margin) >= margin
+                                   : search(SOUTH, 1, margin, margin + 1) <= margin);
+        TurnList::unmake(m_board, p.m_turns[t], m_undos);
+        if (optimal && !m_aborted)
+            moves.push_back(hole);
+    }
+    std::sort(moves.begin(), moves.end());
+}
+
+template <class B>
+int MarginSearch<B>::orderTurns(Side s, int ply, int hint)
+{
+    while (ply >= static_cast<int>(m_plies.size()))
+        m_plies.push_back(Ply());
+    Ply& p = m_plies[ply];
+    int n = p.m_turns.generate(m_board, s);
+    p.m_order.resize(n);
+    for (int t = 0; t < n; t++)
+        p.m_order[t] = t;
+    std::stable_sort(p.m_order.begin(), p.m_order.end(), [&](int a, int b) {
+        bool hintA = (p.m_turns.hole(a, 0) == hint), hintB = (p.m_turns.hole(b, 0) == hint);
+        if (hintA != hintB)
+            return hintA;
+        return p.m_turns[a].m_gain > p.m_turns[b].m_gain;
+    });
+    return n;
+}
+
+} // namespace
+
+Solver::Solver(int tableMegabytes)
+// Construct a Solver whose transposition table uses about tableMegabytes megabytes.
+: m_table(tableMegabytes)
+{
+}
+
+bool Solver::useEndgameDatabase(const std::string& path)
+// Memory-map the endgame database in the indicated file (made by tools/makeendgame.cpp) and
+// look up positions in it from now on. Return false (and use no database) if the file
+// isn't a valid database.
+{
+    return m_endgame.open(path);
+}
+
+bool Solver::solve(const Board& b, Side s, const SearchLimits& limits, Result& result,
+                   std::ostream* progress)
+// Solve position b with s to move, stopping early if limits are reached (the depth limit
+// is ignored), and set result to what was found. Report each pass, and every so often
+// the positions visited and how fast, to *progress if it isn't null. Return
+// result.m_solved.
+{
+    // the margin can't be outside the range the beans on the board allow
+    int potDiff = b.beans(SOUTH, POT) - b.beans(NORTH, POT);
+    int left = b.beansInPlay(SOUTH) + b.beansInPlay(NORTH);
+    result.m_lower = potDiff - left;
+    result.m_upper = potDiff + left;
+    result.m_bestMoves.clear();
+    result.m_passes = 0;
+    m_table.newSearch();
+    withBoard(b, [&](auto& board) {
+        typedef typename std::decay<decltype(board)>::type B;
+        MarginSearch<B> search(board, limits, m_table,
+                               m_endgame.isOpen() ? &m_endgame : nullptr, progress);
+        // MTD(f): each null-window search tells whether the margin is above or below the guess,
+        // which is moved to the bound it returns, until the bounds meet
+        int guess = potDiff;
+        while (result.m_lower < result.m_upper)
+        {
+            int beta = (guess == result.m_lower ? guess + 1 : guess);
+            guess = search.search(s, 0, beta - 1, beta);
+            if (search.aborted())
+                break;
+            if (guess < beta)
+                result.m_upper = guess;
+            else
+                result.m_lower = guess;
+            result.m_passes++;
+            if (progress != nullptr)
+                *progress << "pass " << result.m_passes << ": margin " << result.m_lower << " to "
+                          << result.m_upper << ", " << search.nodes() << " positions in "
+                          << search.seconds() << "s" << std::endl;
+        }
+        if (!search.aborted() && board.beansInPlay(SOUTH) > 0 && board.beansInPlay(NORTH) > 0
+            && board.beansInPlay(s) > 0)
+            search.rootMoves(s, result.m_lower, result.m_bestMoves);
+        result.m_solved = !search.aborted();
+        result.m_nodes = search.nodes();
+        result.m_seconds = search.seconds();
+    });
+    return result.m_solved;
+}
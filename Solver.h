@@ -0,0 +1,62 @@
+#ifndef Solver_h
+#define Solver_h
+#include "Board.h"
+#include "Side.h"
+#include "SearchLimits.h"
+#include "TranspositionTable.h"
+#include "EndgameDatabase.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+//==========================================================================
+// A Solver works out the game-theoretic value of a position: the exact final margin (the beans
+// SOUTH ends the game with minus the beans NORTH does) if both sides play to maximize their own
+// margin, and every first move that achieves it. Unlike SmartPlayer's search, which stops at a
+// depth and only tells wins from losses, it searches every line to the end of the game, so it's
+// only practical for small boards, such as Board(4, 3) or, given time and memory, Board(6, 4).
+//
+// The search is MTD(f): a series of alpha-beta searches with a null window, each of which only
+// finds whether the margin is above or below a guess, moving the guess until the bounds meet. The
+// passes share a large transposition table, so each one mostly reuses the work of the ones before,
+// and positions in an endgame database (if one is given) are looked up instead of searched. It
+// branches on whole turns (see Turns.h), and a position whose beans in play couldn't change the
+// outcome of the null window enough is cut off without searching it.
+//==========================================================================
+
+class Solver
+{
+public:
+    struct Result
+    {
+        bool m_solved; // false if the limits were reached before the bounds met
+        int m_lower; // the margin is at least this...
+        int m_upper; // ...and at most this (the two are equal if m_solved)
+        std::vector<int> m_bestMoves; // every first sowing of an optimal turn, if m_solved
+        long m_nodes; // positions visited
+        double m_seconds; // time taken
+        int m_passes; // null-window searches done
+        int margin() const { return m_lower; }
+            // Return the proven margin, if m_solved.
+        long nodesPerSecond() const
+            { return m_seconds > 0 ? static_cast<long>(m_nodes / m_seconds) : 0; }
+            // Return the number of positions visited per second.
+    };
+    explicit Solver(int tableMegabytes = 256);
+        // Construct a Solver whose transposition table uses about tableMegabytes megabytes.
+    bool useEndgameDatabase(const std::string& path);
+        // Memory-map the endgame database in the indicated file (made by tools/makeendgame.cpp) and
+        // look up positions in it from now on. Return false (and use no database) if the file
+        // isn't a valid database.
+    bool solve(const Board& b, Side s, const SearchLimits& limits, Result& result,
+               std::ostream* progress = nullptr);
+        // Solve position b with s to move, stopping early if limits are reached (the depth limit
+        // is ignored), and set result to what was found. Report each pass, and every so often
+        // the positions visited and how fast, to *progress if it isn't null. Return
+        // result.m_solved.
+private:
+    TranspositionTable m_table; // results kept from one solve to the next
+    EndgameDatabase m_endgame; // margins of positions with few beans left, if open
+};
+
+#endif /* Solver_h */
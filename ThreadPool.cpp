@@ -0,0 +1,65 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int nThreads)
+// Start a pool of nThreads threads; if nThreads isn't positive, start one per processor
+// core.
+: m_running(0), m_stopping(false)
+{
+    if (nThreads <= 0)
+        nThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (nThreads <= 0) // the number of cores isn't known
+        nThreads = 1;
+    for (int i = 0; i < nThreads; i++)
+        m_threads.push_back(std::thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool()
+// Finish the tasks already submitted, then stop the threads.
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_submitted.notify_all();
+    for (size_t i = 0; i < m_threads.size(); i++)
+        m_threads[i].join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+// Have a thread in the pool run task.
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(task);
+    }
+    m_submitted.notify_one();
+}
+
+void ThreadPool::wait()
+// Wait until every task submitted so far has finished.
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_tasks.empty() && m_running == 0; });
+}
+
+//////////
+
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_submitted.wait(lock, [this]() { return !m_tasks.empty() || m_stopping; });
+        if (m_tasks.empty()) // stopping, and nothing left to do
+            return;
+        std::function<void()> task = m_tasks.front();
+        m_tasks.pop_front();
+        m_running++;
+        lock.unlock();
+        task();
+        lock.lock();
+        m_running--;
+        if (m_tasks.empty() && m_running == 0)
+            m_finished.notify_all();
+    }
+}
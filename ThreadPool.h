@@ -0,0 +1,44 @@
+#ifndef ThreadPool_h
+#define ThreadPool_h
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==========================================================================
+// A ThreadPool is a fixed set of threads that run the tasks submitted to it, in the order they were
+// submitted, each on whichever thread is free. It lets a player that searches on several threads
+// for every move start them once instead of once per move.
+//==========================================================================
+
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int nThreads);
+        // Start a pool of nThreads threads; if nThreads isn't positive, start one per processor
+        // core.
+    ~ThreadPool();
+        // Finish the tasks already submitted, then stop the threads.
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    int size() const { return static_cast<int>(m_threads.size()); }
+        // Return the number of threads in the pool.
+    void submit(std::function<void()> task);
+        // Have a thread in the pool run task.
+    void wait();
+        // Wait until every task submitted so far has finished.
+private:
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()> > m_tasks; // submitted, not yet started
+    int m_running; // tasks started, not yet finished
+    bool m_stopping; // the destructor has been called
+    std::mutex m_mutex; // guards the members above, other than m_threads
+    std::condition_variable m_submitted; // signaled when a task is submitted or m_stopping is set
+    std::condition_variable m_finished; // signaled when the last task finishes
+    void work();
+        // Run tasks until the pool is being destroyed and there are no more.
+};
+
+#endif /* ThreadPool_h */
@@ -0,0 +1,190 @@
+#include "Tournament.h"
+#include "Game.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+
+namespace {
+
+const double MAX_SCORE = 0.999; // scores are capped at this (and 1 minus it) before finding an Elo
+const double Z95 = 1.96; // standard deviations either side of the mean covering 95% of outcomes
+
+double eloFromScore(double score)
+// Return the Elo rating difference at which the stronger player's expected score is score.
+{
+    score = std::max(1 - MAX_SCORE, std::min(MAX_SCORE, score));
+    return 400 * std::log10(score / (1 - score));
+}
+
+void writeRecord(std::ostream& out, const Tournament::Record& r)
+// Write r on one line of the table report writes.
+{
+    double low, high;
+    r.eloInterval(low, high);
+    out << std::setw(7) << r.games() << std::setw(7) << r.m_wins << std::setw(7) << r.m_draws
+        << std::setw(7) << r.m_losses << std::setw(8) << std::setprecision(3) << std::fixed
+        << r.score() << std::setw(8) << std::setprecision(0) << r.elo() << "  (" << low << " to "
+        << high << ")" << std::endl;
+    out.unsetf(std::ios::floatfield);
+    out << std::setprecision(6);
+}
+
+} // namespace
+
+double Tournament::Record::score() const
+// Return the fraction of the points won (a draw is worth half a win), or 0.5 if no
+// games were played.
+{
+    return games() > 0 ? (m_wins + 0.5 * m_draws) / games() : 0.5;
+}
+
+double Tournament::Record::elo() const
+// Return the Elo rating difference the score shows (at most 1200 either way).
+{
+    return eloFromScore(score());
+}
+
+void Tournament::Record::eloInterval(double& low, double& high) const
+// Set low and high to the ends of the 95% confidence interval of the Elo difference
+// (the Wilson score interval, which has some width even if every game was won).
+{
+    // the Wilson score interval of the score, which (unlike one from the spread of the points the
+    // games were worth) still has some width when every game was won or every game lost. Points
+    // worth between 0 and 1 with mean s vary by at most s(1 - s), so with draws it's a little wide.
+    int n = games();
+    if (n == 0)
+    {
+        low = eloFromScore(0);
+        high = eloFromScore(1);
+        return;
+    }
+    double s = score();
+    double z2n = Z95 * Z95 / n;
+    double center = (s + z2n / 2) / (1 + z2n);
+    double halfWidth = Z95 / (1 + z2n) * std::sqrt(s * (1 - s) / n + z2n / (4 * n));
+    low = eloFromScore(center - halfWidth);
+    high = eloFromScore(center + halfWidth);
+}
+
+Tournament::Tournament(const Board& b, int threads)
+// Construct a Tournament whose games start from a copy of board b, playing as many games at
+// once as there are threads; if threads isn't positive, one per processor core.
+: m_board(b), m_pool(threads), m_recordWriter(nullptr), m_games(0), m_seconds(0)
+{
+}
+
+void Tournament::addEntrant(const std::string& name, PlayerMaker make)
+// Add an entrant with the indicated name whose players are made by make.
+{
+    Entrant e;
+    e.m_name = name;
+    e.m_make = make;
+    m_entrants.push_back(e);
+    for (size_t i = 0; i < m_entrants.size(); i++)
+        m_entrants[i].m_against.resize(m_entrants.size());
+}
+
+void Tournament::play(int gamesPerPairing, std::ostream* progress)
+// Play gamesPerPairing games between every two entrants (each moving first in half of them,
+// the first entrant added moving first in the extra game if gamesPerPairing is odd), adding
+// the results to the records. Report every tenth of the games finished to *progress if it
+// isn't null.
+{
+    struct Match
+    {
+        int m_south; // entrant moving first
+        int m_north;
+        int m_result; // 1 if SOUTH won, -1 if NORTH won, 0 for a draw
+    };
+    // list the games round by round, so every pairing's games are spread over the whole run
+    std::vector<Match> matches;
+    for (int k = 0; k < gamesPerPairing; k++)
+        for (int i = 0; i < entrants(); i++)
+            for (int j = i + 1; j < entrants(); j++)
+            {
+                Match m = { k % 2 == 0 ? i : j, k % 2 == 0 ? j : i, 0 };
+                matches.push_back(m);
+            }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<long> finished(0);
+    std::mutex progressMutex;
+    const long total = static_cast<long>(matches.size());
+    for (size_t g = 0; g < matches.size(); g++)
+        m_pool.submit([&, g]() {
+            Match& m = matches[g];
+            std::unique_ptr<Player> south = m_entrants[m.m_south].m_make();
+            std::unique_ptr<Player> north = m_entrants[m.m_north].m_make();
+            Game game(m_board, south.get(), north.get());
+            NullObserver quiet;
+            game.setObserver(&quiet);
+            if (m_recordWriter != nullptr)
+                game.setRecordWriter(m_recordWriter);
+            game.play();
+            bool over, hasWinner;
+            Side winner;
+            game.status(over, hasWinner, winner);
+            m.m_result = !hasWinner ? 0 : (winner == SOUTH ? 1 : -1);
+            long done = ++finished;
+            if (progress != nullptr && done * 10 / total != (done - 1) * 10 / total)
+            {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                double t = std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                                         - start).count();
+                *progress << done << " of " << total << " games in " << t << "s" << std::endl;
+            }
+        });
+    m_pool.wait();
+    m_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_games += total;
+    for (size_t g = 0; g < matches.size(); g++)
+    {
+        const Match& m = matches[g];
+        Record& south = m_entrants[m.m_south].m_against[m.m_north];
+        Record& north = m_entrants[m.m_north].m_against[m.m_south];
+        Record& southTotal = m_entrants[m.m_south].m_total;
+        Record& northTotal = m_entrants[m.m_north].m_total;
+        if (m.m_result > 0)
+        {
+            south.m_wins++; southTotal.m_wins++;
+            north.m_losses++; northTotal.m_losses++;
+        }
+        else if (m.m_result < 0)
+        {
+            south.m_losses++; southTotal.m_losses++;
+            north.m_wins++; northTotal.m_wins++;
+        }
+        else
+        {
+            south.m_draws++; southTotal.m_draws++;
+            north.m_draws++; northTotal.m_draws++;
+        }
+    }
+}
+
+void Tournament::report(std::ostream& out) const
+// Write a table of every entrant's results, one of every pairing's, and the number of
+// games played per second to out.
+{
+    size_t width = 8;
+    for (int i = 0; i < entrants(); i++)
+        width = std::max(width, name(i).size() * 2 + 4);
+    out << std::left << std::setw(width) << "entrant" << std::right
+        << "  games   wins  draws losses   score     Elo  (95% interval)" << std::endl;
+    for (int i = 0; i < entrants(); i++)
+    {
+        out << std::left << std::setw(width) << name(i) << std::right;
+        writeRecord(out, record(i));
+    }
+    out << std::endl;
+    for (int i = 0; i < entrants(); i++)
+        for (int j = i + 1; j < entrants(); j++)
+        {
+            out << std::left << std::setw(width) << name(i) + " vs " + name(j) << std::right;
+            writeRecord(out, record(i, j));
+        }
+    out << std::endl << m_games << " games in " << m_seconds << "s (" << gamesPerSecond()
+        << " games/s on " << m_pool.size() << " threads)" << std::endl;
+}
@@ -0,0 +1,98 @@
+#ifndef Tournament_h
+#define Tournament_h
+#include "Board.h"
+#include "GameRecord.h"
+#include "Player.h"
+#include "ThreadPool.h"
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//==========================================================================
+// A Tournament plays every pairing of its entrants against each other many times, without
+// displaying anything, to measure how strong they are relative to each other. Each entrant is a
+// name and a function that makes a new computer player; every game gets new players of its own,
+// so games don't share anything and run at the same time, one per thread of a ThreadPool. Half
+// of each pairing's games are played with each entrant moving first.
+//
+// For each pairing and each entrant (against the rest of the field together) it keeps the wins,
+// draws and losses, and from them the Elo rating difference they show, with a 95% confidence
+// interval.
+//==========================================================================
+
+class Tournament
+{
+public:
+    typedef std::function<std::unique_ptr<Player>()> PlayerMaker;
+        // Makes a new player for one game. It's called on the thread that plays the game, so it
+        // must be safe to call from several threads at once. Since it's called for every game, the
+        // players it makes should be cheap to make: a SmartPlayer, for one, should have a
+        // transposition table only as big as a search of one move can fill.
+    struct Record
+    {
+        int m_wins;
+        int m_draws;
+        int m_losses;
+        Record() : m_wins(0), m_draws(0), m_losses(0) {}
+        int games() const { return m_wins + m_draws + m_losses; }
+            // Return the number of games played.
+        double score() const;
+            // Return the fraction of the points won (a draw is worth half a win), or 0.5 if no
+            // games were played.
+        double elo() const;
+            // Return the Elo rating difference the score shows (at most 1200 either way).
+        void eloInterval(double& low, double& high) const;
+            // Set low and high to the ends of the 95% confidence interval of the Elo difference
+            // (the Wilson score interval, which has some width even if every game was won).
+    };
+    explicit Tournament(const Board& b, int threads = 0);
+        // Construct a Tournament whose games start from a copy of board b, playing as many games at
+        // once as there are threads; if threads isn't positive, one per processor core. Each player
+        // should search on one thread, or the games slow each other down.
+    void addEntrant(const std::string& name, PlayerMaker make);
+        // Add an entrant with the indicated name whose players are made by make. Only computer
+        // players can take part.
+    void setRecordWriter(GameRecordWriter* writer) { m_recordWriter = writer; }
+        // Record every game played from now on with writer (see GameRecord.h), or no game if writer
+        // is null. The Tournament doesn't take ownership of writer.
+    void play(int gamesPerPairing, std::ostream* progress = nullptr);
+        // Play gamesPerPairing games between every two entrants (each moving first in half of them,
+        // the first entrant added moving first in the extra game if gamesPerPairing is odd), adding
+        // the results to the records. Report every tenth of the games finished to *progress if it
+        // isn't null.
+    int entrants() const { return static_cast<int>(m_entrants.size()); }
+        // Return the number of entrants.
+    const std::string& name(int i) const { return m_entrants[i].m_name; }
+        // Return the name of entrant i (numbered from 0 in the order they were added).
+    const Record& record(int i) const { return m_entrants[i].m_total; }
+        // Return the results of entrant i against every other entrant.
+    const Record& record(int i, int j) const { return m_entrants[i].m_against[j]; }
+        // Return the results of entrant i against entrant j.
+    long games() const { return m_games; }
+        // Return the number of games played.
+    double seconds() const { return m_seconds; }
+        // Return the time spent playing them.
+    double gamesPerSecond() const { return m_seconds > 0 ? m_games / m_seconds : 0; }
+        // Return the number of games played per second.
+    void report(std::ostream& out) const;
+        // Write a table of every entrant's results, one of every pairing's, and the number of
+        // games played per second to out.
+private:
+    struct Entrant
+    {
+        std::string m_name;
+        PlayerMaker m_make;
+        Record m_total; // results against everyone
+        std::vector<Record> m_against; // m_against[j]: results against entrant j
+    };
+    Board m_board;
+    ThreadPool m_pool;
+    std::vector<Entrant> m_entrants;
+    GameRecordWriter* m_recordWriter; // where to record games, or null
+    long m_games; // games played
+    double m_seconds; // time spent playing them
+};
+
+#endif /* Tournament_h */
@@ -0,0 +1,137 @@
+#include "TranspositionTable.h"
+#include <cstddef>
+
+namespace {
+
+inline std::uint64_t pack(int value, int depth, int bound, int move, int generation)
+{
+    return static_cast<std::uint32_t>(value) | static_cast<std::uint64_t>(depth) << 32
+        | static_cast<std::uint64_t>(bound) << 40 | static_cast<std::uint64_t>(move) << 48
+        | static_cast<std::uint64_t>(generation) << 56;
+}
+
+inline int valueOf(std::uint64_t data) { return static_cast<std::int32_t>(data & 0xFFFFFFFF); }
+inline int depthOf(std::uint64_t data) { return (data >> 32) & 0xFF; }
+inline int boundOf(std::uint64_t data) { return (data >> 40) & 0xFF; }
+inline int moveOf(std::uint64_t data) { return (data >> 48) & 0xFF; }
+inline int generationOf(std::uint64_t data) { return (data >> 56) & 0xFF; }
+
+bool replaces(int depth, int bound, std::uint64_t old, int generation)
+// Return true if a result searched depth turns deep with the indicated bound is worth more than
+// the entry old for the same position: old is from an earlier search, or the new result is at
+// least as deep, or it's exact and old didn't reach the end of the game.
+{
+    return generationOf(old) != generation || depth == TranspositionTable::COMPLETE
+        || depth >= depthOf(old)
+        || (bound == TranspositionTable::EXACT && depthOf(old) != TranspositionTable::COMPLETE);
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(int megabytes)
+// Construct a table that uses about the indicated number of megabytes (rounded down to a
+// power of two number of buckets, but at least one bucket).
+{
+    std::uint64_t bytes = (megabytes > 0 ? static_cast<std::uint64_t>(megabytes) : 0) << 20;
+    std::uint64_t nBuckets = 1;
+    while (nBuckets * 2 * sizeof(Bucket) <= bytes)
+        nBuckets *= 2;
+    m_buckets.reset(new Bucket[nBuckets]);
+    m_mask = nBuckets - 1;
+    m_generation = 0;
+    clear();
+}
+
+void TranspositionTable::clear()
+// Forget everything. No other thread may be using the table.
+{
+    for (std::uint64_t i = 0; i <= m_mask; i++)
+        for (int j = 0; j < BUCKET_SIZE; j++)
+        {
+            m_buckets[i].m_entries[j].m_check.store(0, std::memory_order_relaxed);
+            m_buckets[i].m_entries[j].m_data.store(pack(0, 0, NONE, 0, 0), std::memory_order_relaxed);
+        }
+}
+
+void TranspositionTable::newSearch()
+// Mark the start of a new search; entries from earlier searches are replaced first. No
+// other thread may be using the table.
+{
+    m_generation++;
+}
+
+bool TranspositionTable::probe(std::uint64_t key, int& depth, Bound& bound, int& value, int& move) const
+// If there is an entry for key, set depth, bound, value and move (the best move found, or 0
+// if none was) to what was stored and return true. Otherwise, return false.
+{
+    const Bucket& b = m_buckets[key & m_mask];
+    for (int j = 0; j < BUCKET_SIZE; j++)
+    {
+        const Entry& e = b.m_entries[j];
+        std::uint64_t data = e.m_data.load(std::memory_order_relaxed);
+        std::uint64_t check = e.m_check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && boundOf(data) != NONE)
+        {
+            depth = depthOf(data);
+            bound = Bound(boundOf(data));
+            value = valueOf(data);
+            move = moveOf(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, int depth, Bound bound, int value, int move)
+// Store the result of searching the position with the indicated key depth turns deep
+// (or COMPLETE). Depths from COMPLETE - 1 up are stored as COMPLETE - 1. If this search has
+// already stored a deeper result for the position that this one doesn't improve on, keep it.
+{
+    if (depth != COMPLETE && depth > COMPLETE - 1)
+        depth = COMPLETE - 1;
+    if (move < 0 || move > 255) // doesn't fit; store no move
+        move = 0;
+    Bucket& b = m_buckets[key & m_mask];
+    // use the entry already holding this position if there is one; otherwise replace the entry
+    // worth least: the one from the oldest search, and among those the shallowest
+    Entry* victim = &b.m_entries[0];
+    int victimWorth = 1 << 30;
+    for (int j = 0; j < BUCKET_SIZE; j++)
+    {
+        Entry& e = b.m_entries[j];
+        std::uint64_t data = e.m_data.load(std::memory_order_relaxed);
+        std::uint64_t check = e.m_check.load(std::memory_order_relaxed);
+        bool same = (check ^ data) == key;
+        if (same && boundOf(data) != NONE && !replaces(depth, bound, data, m_generation))
+        {
+            // another thread, searching at a different depth, may have stored something better for
+            // this position in this search; keep it, taking only a best move it didn't have (its own,
+            // found by the deeper search, orders moves better)
+            if (move != 0 && moveOf(data) == 0)
+            {
+                data = (data & ~(static_cast<std::uint64_t>(0xFF) << 48))
+                    | static_cast<std::uint64_t>(move) << 48;
+                e.m_data.store(data, std::memory_order_relaxed);
+                e.m_check.store(key ^ data, std::memory_order_relaxed);
+            }
+            return;
+        }
+        if (same || boundOf(data) == NONE)
+        {
+            if (same && move == 0) // keep the move we knew about
+                move = moveOf(data);
+            victim = &e;
+            break;
+        }
+        int age = static_cast<std::uint8_t>(m_generation - generationOf(data));
+        int worth = depthOf(data) - 8 * age;
+        if (worth < victimWorth)
+        {
+            victim = &e;
+            victimWorth = worth;
+        }
+    }
+    std::uint64_t data = pack(value, depth, bound, move, m_generation);
+    victim->m_data.store(data, std::memory_order_relaxed);
+    victim->m_check.store(key ^ data, std::memory_order_relaxed);
+}
@@ -0,0 +1,69 @@
+#ifndef TranspositionTable_h
+#define TranspositionTable_h
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+//==========================================================================
+// A TranspositionTable remembers the results of searching positions, keyed by a 64-bit hash of the
+// position and side to move, so a search that reaches the same position again (by a different
+// order of moves, or at the next depth of iterative deepening) can reuse them. It has a fixed size
+// chosen at construction. Entries are grouped four to a 64-byte bucket, one cache line, and a
+// position can only be stored in the bucket its key selects; when that bucket is full, the entry
+// replaced is the least valuable one: entries left over from earlier searches go first, then the
+// ones searched least deeply.
+//
+// Several threads may probe and store at the same time without any locking. Each entry is two
+// 64-bit words, the packed data and the key XORed with the data, each read and written atomically;
+// an entry whose two words come from different stores (because two threads wrote it at once)
+// simply doesn't match any key, so a probe never returns data stored for another position.
+//==========================================================================
+
+class TranspositionTable
+{
+public:
+    enum Bound { NONE, EXACT, LOWER, UPPER };
+        // What a stored value means: the position's exact value, a lower bound on it (the search
+        // stopped early because it was already too good for the other player to allow), or an
+        // upper bound.
+    static const int COMPLETE = 255;
+        // Depth stored for a result that reached the end of the game on every line, so it holds
+        // no matter how deep a search wants to look.
+    explicit TranspositionTable(int megabytes);
+        // Construct a table that uses about the indicated number of megabytes (rounded down to a
+        // power of two number of buckets, but at least one bucket).
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+    void clear();
+        // Forget everything. No other thread may be using the table.
+    void newSearch();
+        // Mark the start of a new search; entries from earlier searches are replaced first. No
+        // other thread may be using the table.
+    bool probe(std::uint64_t key, int& depth, Bound& bound, int& value, int& move) const;
+        // If there is an entry for key, set depth, bound, value and move (the best move found, or 0
+        // if none was) to what was stored and return true. Otherwise, return false.
+    void store(std::uint64_t key, int depth, Bound bound, int value, int move);
+        // Store the result of searching the position with the indicated key depth turns deep
+        // (or COMPLETE). Depths from COMPLETE - 1 up are stored as COMPLETE - 1. If this search has
+        // already stored a deeper result for the position, that's kept (taking move only if it had
+        // none) unless this one is exact and that one isn't COMPLETE.
+private:
+    struct Entry
+    {
+        // m_data packs the value (bits 0-31), depth (32-39), bound (40-47; NONE for an empty
+        // entry), best move (48-55; 0 if none or if it doesn't fit) and the generation it was
+        // stored in (56-63).
+        std::atomic<std::uint64_t> m_check; // key ^ m_data
+        std::atomic<std::uint64_t> m_data;
+    };
+    static const int BUCKET_SIZE = 4;
+    struct alignas(64) Bucket
+    {
+        Entry m_entries[BUCKET_SIZE];
+    };
+    std::unique_ptr<Bucket[]> m_buckets;
+    std::uint64_t m_mask; // number of buckets - 1
+    std::uint8_t m_generation; // incremented by newSearch
+};
+
+#endif /* TranspositionTable_h */
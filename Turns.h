@@ -0,0 +1,123 @@
+#ifndef Turns_h
+#define Turns_h
+#include "Side.h"
+#include <cstdint>
+#include <vector>
+
+//==========================================================================
+// A TurnList holds every complete turn a side can take in a position. A turn is the whole chain of
+// sowings a player makes before the opponent moves: each sowing whose last bean lands in the
+// player's own pot earns another, so a turn is one or more sowings, the last of which either ends
+// somewhere else (perhaps with a capture) or ends the game. Different chains of sowings can leave
+// exactly the same position; such turns are listed only once, so a search that branches on turns
+// searches each position the opponent can be left with once.
+//
+// The list works with any board type B (Board or one of the BoardT<N>): generate makes the
+// sowings on the board itself, to see where they lead, and takes them back, and make and unmake
+// play a listed turn on a board and take it back.
+//==========================================================================
+
+class TurnList
+{
+public:
+    struct Turn
+    {
+        int m_first; // index in the list's holes of the turn's first sowing
+        int m_length; // number of sowings
+        std::uint64_t m_hash; // hash of the position the turn leaves
+        int m_gain; // beans the turn puts in the player's pot
+    };
+    template <class B>
+    int generate(B& b, Side s);
+        // Replace the list with every distinct turn s can take on board b (which is changed while
+        // the turns are worked out, but restored by the end) and return how many there are. If s
+        // has no beans in play, there are none. Turns are listed in order of their sowings' hole
+        // numbers, smallest first; of several that leave the same position, the first is kept.
+    int size() const { return static_cast<int>(m_turns.size()); }
+        // Return the number of turns in the list.
+    const Turn& operator[](int i) const { return m_turns[i]; }
+        // Return the indicated turn.
+    int hole(int i, int k) const { return m_holes[m_turns[i].m_first + k]; }
+        // Return the hole sown by the kth sowing (counting from 0) of the indicated turn.
+    template <class B>
+    void make(B& b, Side s, int i, std::vector<typename B::Undo>& undos) const;
+        // Make every sowing (and any capture) of turn i by s on board b, adding what's needed to
+        // take each back to undos.
+    template <class B>
+    static void unmake(B& b, const Turn& turn, std::vector<typename B::Undo>& undos);
+        // Take back the indicated turn, made by make with the same undos.
+private:
+    std::vector<Turn> m_turns;
+    std::vector<int> m_holes; // every turn's holes, one turn after another
+    std::vector<int> m_path; // holes sown so far by the turn generate is extending
+    template <class B>
+    void extend(B& b, Side s, int potBefore);
+        // Add every turn that begins with the sowings in m_path (already made on b by s).
+};
+
+//////////
+
+template <class B>
+int TurnList::generate(B& b, Side s)
+{
+    m_turns.clear();
+    m_holes.clear();
+    m_path.clear();
+    extend(b, s, b.beans(s, POT));
+    return size();
+}
+
+template <class B>
+void TurnList::extend(B& b, Side s, int potBefore)
+{
+    for (int hole = 1; hole <= b.holes(); hole++)
+    {
+        typename B::Undo undo;
+        if (!b.makeMove(s, hole, undo)) // hole is empty, can't choose
+            continue;
+        m_path.push_back(hole);
+        // another sowing follows if the last bean landed in the pot and the game isn't over
+        if (undo.extraTurn() && b.beansInPlay(SOUTH) > 0 && b.beansInPlay(NORTH) > 0)
+            extend(b, s, potBefore);
+        else
+        {
+            std::uint64_t hash = b.hash();
+            bool seen = false;
+            for (size_t i = 0; i < m_turns.size() && !seen; i++)
+                seen = (m_turns[i].m_hash == hash);
+            if (!seen)
+            {
+                Turn turn = { static_cast<int>(m_holes.size()), static_cast<int>(m_path.size()),
+                              hash, b.beans(s, POT) - potBefore };
+                m_turns.push_back(turn);
+                m_holes.insert(m_holes.end(), m_path.begin(), m_path.end());
+            }
+        }
+        m_path.pop_back();
+        b.unmakeMove(undo);
+    }
+}
+
+template <class B>
+void TurnList::make(B& b, Side s, int i, std::vector<typename B::Undo>& undos) const
+{
+    const Turn& turn = m_turns[i];
+    for (int k = 0; k < turn.m_length; k++)
+    {
+        typename B::Undo undo;
+        b.makeMove(s, m_holes[turn.m_first + k], undo);
+        undos.push_back(undo);
+    }
+}
+
+template <class B>
+void TurnList::unmake(B& b, const Turn& turn, std::vector<typename B::Undo>& undos)
+{
+    for (int k = 0; k < turn.m_length; k++)
+    {
+        b.unmakeMove(undos.back());
+        undos.pop_back();
+    }
+}
+
+#endif /* Turns_h */
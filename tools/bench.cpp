@@ -0,0 +1,263 @@
+//==========================================================================
+// bench: time the operations the game and the search spend their time in (constructing and
+// copying boards, beans, sow at several bean counts, moveToPot, makeMove and unmakeMove,
+// Game::status) on Board and on BoardT<6>, and SmartPlayer::chooseMove at a fixed depth on a set of
+// reference positions, and write the results as CSV (the default) or JSON.
+//
+//     bench [csv|json] [quick]
+//
+// Every benchmark does the same work on every run: the positions are fixed, and each timing is
+// the fastest of several repetitions, to keep out noise from the rest of the machine. quick does
+// a tenth of the iterations and searches three turns less deep, to check that it runs. Build it
+// from the top directory of the project with
+//
+//     g++ -std=c++17 -O2 -pthread -o bench tools/bench.cpp Game.cpp GameObserver.cpp GameRecord.cpp Player.cpp Board.cpp TranspositionTable.cpp EndgameDatabase.cpp OpeningBook.cpp ThreadPool.cpp
+//==========================================================================
+
+#include "../Board.h"
+#include "../BoardT.h"
+#include "../Game.h"
+#include "../Player.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int REPEATS = 5; // times each benchmark is run; the fastest counts
+
+struct Result
+{
+    std::string m_name; // what was timed
+    std::string m_variant; // on what (board type, bean count or position)
+    long m_iterations; // operations per repetition
+    double m_nsPerOp; // nanoseconds per operation, in the fastest repetition
+    long m_nodes; // for searches, positions visited (0 otherwise)
+    long m_nodesPerSecond;
+};
+
+volatile long sink; // results are added here so the compiler can't skip the work
+
+template <class F>
+double nsPerOp(long iterations, F f)
+// Call f(iterations) REPEATS times and return the fastest time per iteration in nanoseconds.
+{
+    double best = 0;
+    for (int r = 0; r < REPEATS; r++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        f(iterations);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now()
+                                                              - start).count();
+        if (r == 0 || ns < best)
+            best = ns;
+    }
+    return best / iterations;
+}
+
+void add(std::vector<Result>& results, const std::string& name, const std::string& variant,
+         long iterations, double ns)
+// Add the result of a benchmark other than a search.
+{
+    Result r = { name, variant, iterations, ns, 0, 0 };
+    results.push_back(r);
+}
+
+template <class B>
+void boardBenchmarks(std::vector<Result>& results, const std::string& variant, long n,
+                     const B& start)
+// Time the operations of board type B, starting from the standard position start (6 holes, 4
+// beans per hole).
+{
+    add(results, "copy", variant, n, nsPerOp(n, [&](long k) {
+        for (long i = 0; i < k; i++)
+        {
+            B b(start);
+            sink = sink + b.beans(SOUTH, 1 + i % 6);
+        }
+    }));
+    add(results, "beans", variant, n * 14, nsPerOp(n, [&](long k) {
+        long total = 0;
+        for (long i = 0; i < k; i++)
+            for (int hole = 0; hole <= 6; hole++)
+                total += start.beans(SOUTH, hole) + start.beans(NORTH, hole);
+        sink = sink + total;
+    }) / 14);
+    // sowing changes the board, so each one starts by assigning the position back (the copy above
+    // shows what that costs)
+    static const int SOWN[] = { 1, 4, 13, 40 };
+    for (int beans : SOWN)
+    {
+        B base(start);
+        base.setBeans(SOUTH, 3, beans);
+        add(results, "sow", variant + " " + std::to_string(beans) + " beans", n,
+            nsPerOp(n, [&](long k) {
+                B b(base);
+                Side endSide;
+                int endHole = 0;
+                for (long i = 0; i < k; i++)
+                {
+                    b = base;
+                    b.sow(SOUTH, 3, endSide, endHole);
+                    sink = sink + endHole;
+                }
+            }));
+    }
+    add(results, "moveToPot", variant, n, nsPerOp(n, [&](long k) {
+        B b(start);
+        for (long i = 0; i < k; i++)
+        {
+            b = start;
+            b.moveToPot(NORTH, 1 + i % 6, SOUTH);
+            sink = sink + b.beans(SOUTH, POT);
+        }
+    }));
+    add(results, "makeMove+unmakeMove", variant, n, nsPerOp(n, [&](long k) {
+        B b(start);
+        Board::Undo undo;
+        for (long i = 0; i < k; i++)
+        {
+            if (b.makeMove(SOUTH, 1 + i % 6, undo))
+                b.unmakeMove(undo);
+        }
+        sink = sink + b.beans(SOUTH, POT);
+    }));
+}
+
+Board referencePosition(int nHoles, int nBeans, int plies)
+// Return the position after plies sowings from Board(nHoles, nBeans), always sowing the
+// fullest hole of the side to move (the lowest numbered one of those tied), with captures and
+// extra turns as in a Game.
+{
+    Board b(nHoles, nBeans);
+    Side s = SOUTH;
+    for (int p = 0; p < plies && b.beansInPlay(SOUTH) > 0 && b.beansInPlay(NORTH) > 0; p++)
+    {
+        int best = 1;
+        for (int hole = 2; hole <= nHoles; hole++)
+            if (b.beans(s, hole) > b.beans(s, best))
+                best = hole;
+        Board::Undo undo;
+        b.makeMove(s, best, undo);
+        if (!undo.extraTurn())
+            s = opponent(s);
+    }
+    return b;
+}
+
+void searchBenchmark(std::vector<Result>& results, const std::string& variant, const Board& b,
+                     int depth)
+// Time a fresh single-threaded SmartPlayer choosing SOUTH's move in position b, searching
+// depth turns deep. (Every repetition visits the same positions, so the node count is a check
+// that the search itself hasn't changed.)
+{
+    SearchStats best;
+    for (int r = 0; r < REPEATS; r++)
+    {
+        SmartPlayer player("bench", 0, depth, 16, 1);
+        player.chooseMove(b, SOUTH);
+        if (r == 0 || player.lastStats().m_seconds < best.m_seconds)
+            best = player.lastStats();
+    }
+    Result r = { "chooseMove", variant + " depth " + std::to_string(depth), 1,
+                 best.m_seconds * 1e9, best.m_nodes, best.nodesPerSecond() };
+    results.push_back(r);
+}
+
+void writeCsv(std::ostream& out, const std::vector<Result>& results)
+{
+    out << "name,variant,iterations,ns_per_op,nodes,nodes_per_second" << std::endl;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        out << r.m_name << ',' << r.m_variant << ',' << r.m_iterations << ',' << r.m_nsPerOp << ','
+            << r.m_nodes << ',' << r.m_nodesPerSecond << std::endl;
+    }
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results)
+{
+    out << "[" << std::endl;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        out << "  {\"name\": \"" << r.m_name << "\", \"variant\": \"" << r.m_variant
+            << "\", \"iterations\": " << r.m_iterations << ", \"ns_per_op\": " << r.m_nsPerOp
+            << ", \"nodes\": " << r.m_nodes << ", \"nodes_per_second\": " << r.m_nodesPerSecond
+            << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool json = false, quick = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "json") == 0)
+            json = true;
+        else if (std::strcmp(argv[i], "quick") == 0)
+            quick = true;
+        else if (std::strcmp(argv[i], "csv") != 0)
+        {
+            std::cerr << "usage: " << argv[0] << " [csv|json] [quick]" << std::endl;
+            return 2;
+        }
+    }
+    long n = (quick ? 100000 : 1000000);
+    int extraDepth = (quick ? 0 : 3);
+    std::vector<Result> results;
+
+    add(results, "construct", "Board", n, nsPerOp(n, [](long k) {
+        for (long i = 0; i < k; i++)
+        {
+            Board b(6, 4);
+            sink = sink + b.totalBeans();
+        }
+    }));
+    add(results, "construct", "BoardT<6>", n, nsPerOp(n, [](long k) {
+        for (long i = 0; i < k; i++)
+        {
+            BoardT<6> b(4);
+            sink = sink + b.totalBeans();
+        }
+    }));
+    add(results, "construct", "Board 20 holes", n, nsPerOp(n, [](long k) {
+        for (long i = 0; i < k; i++) // too many holes to keep inside the Board
+        {
+            Board b(20, 4);
+            sink = sink + b.totalBeans();
+        }
+    }));
+    Board start(6, 4);
+    boardBenchmarks(results, "Board", n, start);
+    boardBenchmarks(results, "BoardT<6>", n, BoardT<6>(start));
+
+    BadPlayer south("South"), north("North");
+    Game game(referencePosition(6, 4, 10), &south, &north);
+    add(results, "Game::status", "6x4 after 10 sowings", n, nsPerOp(n, [&](long k) {
+        bool over, hasWinner;
+        Side winner;
+        for (long i = 0; i < k; i++)
+        {
+            game.status(over, hasWinner, winner);
+            sink = sink + over;
+        }
+    }));
+
+    searchBenchmark(results, "6x4 start", Board(6, 4), 6 + extraDepth);
+    searchBenchmark(results, "6x4 after 10 sowings", referencePosition(6, 4, 10), 6 + extraDepth);
+    searchBenchmark(results, "6x6 start", Board(6, 6), 5 + extraDepth);
+    searchBenchmark(results, "4x4 start", Board(4, 4), 8 + extraDepth);
+    searchBenchmark(results, "8x5 after 20 sowings", referencePosition(8, 5, 20), 4 + extraDepth);
+
+    if (json)
+        writeJson(std::cout, results);
+    else
+        writeCsv(std::cout, results);
+    return 0;
+}
@@ -0,0 +1,109 @@
+//==========================================================================
+// hostgames: play many games at once on a GameHost (see GameHost.h) and print how they ended and
+// how long they took, to show how many games a few threads can keep going.
+//
+//     hostgames [-t threads] [-d depth] [-r] games [holes beans]
+//
+// Every game starts from Board(holes, beans) (6 holes of 4 beans if not given), with a SmartPlayer
+// searching depth turns deep (4 if not given) moving first against, in turn, a SmartPlayer
+// searching half as deep and a BadPlayer. With -r, every other game's second player is a
+// RemotePlayer instead, whose moves (the leftmost legal hole, a moment after it's asked) come from
+// this program's main thread the way a person's would come over a network, so a game waiting for
+// one uses no thread at all. The games are played on threads threads (1 if not given; 0 for one
+// per processor core). Each player has a transposition table of the smallest size, so that
+// thousands of them fit in memory. Build it from the top directory of the project with
+//
+//     g++ -std=c++17 -O2 -pthread -o hostgames tools/hostgames.cpp GameHost.cpp Game.cpp GameObserver.cpp GameRecord.cpp Player.cpp Board.cpp TranspositionTable.cpp EndgameDatabase.cpp OpeningBook.cpp ThreadPool.cpp
+//==========================================================================
+
+#include "../GameHost.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    int threads = 1, depth = 4;
+    bool remote = false;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            depth = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "-r") == 0)
+            remote = true;
+        else
+            break;
+    }
+    int games = (i < argc ? std::atoi(argv[i]) : 0);
+    int nHoles = (argc - i == 3 ? std::atoi(argv[i + 1]) : 6);
+    int nBeans = (argc - i == 3 ? std::atoi(argv[i + 2]) : 4);
+    if (games <= 0 || depth <= 0 || nHoles <= 0 || nBeans < 0 || (argc - i != 1 && argc - i != 3))
+    {
+        std::cerr << "usage: " << argv[0] << " [-t threads] [-d depth] [-r] games [holes beans]"
+                  << std::endl;
+        return 2;
+    }
+    std::vector<std::unique_ptr<Player> > players;
+    std::vector<RemotePlayer*> remotes;
+    GameHost host(threads);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int g = 0; g < games; g++)
+    {
+        players.push_back(std::unique_ptr<Player>(new SmartPlayer("Smart", 0, depth, 0, 1)));
+        Player* south = players.back().get();
+        if (remote && g % 2 == 1)
+        {
+            RemotePlayer* r = new RemotePlayer("Remote");
+            remotes.push_back(r);
+            players.push_back(std::unique_ptr<Player>(r));
+        }
+        else if (g % 4 < 2)
+            players.push_back(std::unique_ptr<Player>(new SmartPlayer("Shallow", 0,
+                                                                      (depth + 1) / 2, 0, 1)));
+        else
+            players.push_back(std::unique_ptr<Player>(new BadPlayer("Bad")));
+        host.add(Board(nHoles, nBeans), south, players.back().get());
+    }
+    // play the remote players' moves, as people elsewhere would
+    long remoteMoves = 0;
+    while (host.playing() > 0)
+    {
+        for (size_t k = 0; k < remotes.size(); k++)
+        {
+            Board b(1, 0);
+            Side s;
+            if (!remotes[k]->waiting(b, s))
+                continue;
+            int hole = 1;
+            while (b.beans(s, hole) == 0)
+                hole++;
+            remoteMoves += remotes[k]->submitMove(hole);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    host.wait();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long results[3] = { 0, 0, 0 }; // SOUTH wins, NORTH wins, ties
+    for (int g = 0; g < games; g++)
+    {
+        bool hasWinner;
+        Side winner;
+        int southBeans, northBeans;
+        if (host.result(g, hasWinner, winner, southBeans, northBeans))
+            results[!hasWinner ? 2 : (winner == SOUTH ? 0 : 1)]++;
+    }
+    std::cout << games << " games on " << host.threads() << " threads: SOUTH won " << results[0]
+              << ", NORTH won " << results[1] << ", " << results[2] << " ties" << std::endl;
+    if (remote)
+        std::cout << remoteMoves << " moves submitted for remote players" << std::endl;
+    std::cout << "played in " << t << "s (" << (t > 0 ? static_cast<long>(games / t) : 0)
+              << " games/s)" << std::endl;
+    return 0;
+}
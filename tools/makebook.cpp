@@ -0,0 +1,38 @@
+//==========================================================================
+// makebook: search the positions from the first few sowings of games that start from the
+// standard boards of the given sizes, and write the chosen moves to an opening book file that
+// SmartPlayer::useOpeningBook can load.
+//
+//     makebook file plies depth holes beans [holes beans ...]
+//
+// searches every position reachable in plies sowings from Board(holes, beans) for each pair, to
+// depth turns deep, on every processor core. Build it from the top directory of the project with
+//
+//     g++ -std=c++17 -O2 -pthread -o makebook tools/makebook.cpp OpeningBook.cpp Player.cpp Board.cpp TranspositionTable.cpp EndgameDatabase.cpp ThreadPool.cpp
+//==========================================================================
+
+#include "../OpeningBook.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 6 || argc % 2 != 0)
+    {
+        std::cerr << "usage: " << argv[0] << " file plies depth holes beans [holes beans ...]" << std::endl;
+        return 2;
+    }
+    int plies = std::atoi(argv[2]);
+    int depth = std::atoi(argv[3]);
+    std::vector<Board> starts;
+    for (int i = 4; i + 1 < argc; i += 2)
+        starts.push_back(Board(std::atoi(argv[i]), std::atoi(argv[i + 1])));
+    if (!OpeningBook::build(starts, plies, depth, argv[1], 0, &std::cout))
+    {
+        std::cerr << "couldn't make a book of " << plies << " sowings searched " << depth
+                  << " deep in " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
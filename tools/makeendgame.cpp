@@ -0,0 +1,33 @@
+//==========================================================================
+// makeendgame: solve every Kalah position with a given number of holes per side and at most a
+// given number of beans left in the holes, and write them to an endgame database file that
+// SmartPlayer::useEndgameDatabase can load.
+//
+//     makeendgame holes maxBeans file
+//
+// Build it from the top directory of the project with
+//
+//     g++ -std=c++17 -O2 -o makeendgame tools/makeendgame.cpp EndgameDatabase.cpp Board.cpp
+//==========================================================================
+
+#include "../EndgameDatabase.h"
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 4)
+    {
+        std::cerr << "usage: " << argv[0] << " holes maxBeans file" << std::endl;
+        return 2;
+    }
+    int nHoles = std::atoi(argv[1]);
+    int maxBeans = std::atoi(argv[2]);
+    if (!EndgameDatabase::generate(nHoles, maxBeans, argv[3], &std::cout))
+    {
+        std::cerr << "couldn't make a database of " << nHoles << "-hole positions with up to "
+                  << maxBeans << " beans in " << argv[3] << std::endl;
+        return 1;
+    }
+    return 0;
+}
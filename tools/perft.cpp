@@ -0,0 +1,161 @@
+//==========================================================================
+// perft: count the sequences of complete turns that can be played to a given depth from a
+// position (see Perft.h), to check move generation and measure its speed.
+//
+//     perft [-t threads] [-d] [-n] depth holes beans
+//     perft [-t threads] [-d] [-n] depth s1,...,sN,southPot,n1,...,nN,northPot
+//     perft [-t threads] -c
+//
+// The first form starts from Board(holes, beans), the second from a position given as the beans
+// in SOUTH's holes 1 to N, SOUTH's pot, NORTH's holes 1 to N and NORTH's pot. SOUTH moves first
+// unless -n is given. -t counts on that many threads (1 if not given; 0 for one per processor
+// core), and -d lists each of the first player's turns with the number below it. -c checks the
+// counts for the standard starting positions against the table below and prints how long each
+// took. Build it from the top directory of the project with
+//
+//     g++ -std=c++17 -O2 -pthread -o perft tools/perft.cpp Perft.cpp Board.cpp ThreadPool.cpp
+//==========================================================================
+
+#include "../Perft.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// Counts for standard starting positions, SOUTH to move, at depths 1 to 8. They were worked out by
+// a separate, deliberately simple implementation of the rules in Game::move (sowing with
+// Board::sow and capturing with Board::moveToPot on a fresh copy of the board for every sowing),
+// which agrees with perft on hundreds of random positions.
+struct Reference
+{
+    int m_holes;
+    int m_beans;
+    std::uint64_t m_leaves[8];
+};
+
+const Reference REFERENCE[] = {
+    { 4, 3, { 6, 40, 229, 911, 3912, 15025, 61757, 229425 } },
+    { 4, 4, { 6, 24, 83, 309, 1349, 5158, 30495, 145607 } },
+    { 6, 3, { 10, 106, 818, 6834, 61241, 676098, 7958403, 76547123 } },
+    { 6, 4, { 10, 116, 1022, 9682, 125843, 1090937, 10171475, 80250512 } },
+    { 6, 5, { 10, 108, 1055, 6727, 44695, 292196, 2204390, 15382870 } },
+    { 6, 6, { 10, 60, 329, 1907, 12441, 80209, 605596, 4240545 } },
+};
+
+bool parsePosition(const std::string& text, Board& b)
+// Set b to the position given in text as comma-separated bean counts (see above). Return false if
+// text isn't such a list.
+{
+    std::vector<int> counts;
+    std::istringstream in(text);
+    std::string field;
+    while (std::getline(in, field, ','))
+    {
+        char* end;
+        long n = std::strtol(field.c_str(), &end, 10);
+        if (field.empty() || *end != '\0' || n < 0)
+            return false;
+        counts.push_back(static_cast<int>(n));
+    }
+    if (counts.size() < 4 || counts.size() % 2 != 0)
+        return false;
+    int nHoles = static_cast<int>(counts.size()) / 2 - 1;
+    b = Board(nHoles, 0);
+    for (int hole = 1; hole <= nHoles; hole++)
+    {
+        b.setBeans(SOUTH, hole, counts[hole - 1]);
+        b.setBeans(NORTH, hole, counts[nHoles + hole]);
+    }
+    b.setBeans(SOUTH, POT, counts[nHoles]);
+    b.setBeans(NORTH, POT, counts[2 * nHoles + 1]);
+    return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int check(int threads)
+// Check every count in REFERENCE, printing each result, and return 0 if they all match (1
+// otherwise).
+{
+    int failures = 0;
+    for (const Reference& r : REFERENCE)
+        for (int depth = 1; depth <= 8; depth++)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::uint64_t n = perft(Board(r.m_holes, r.m_beans), SOUTH, depth, threads);
+            bool ok = (n == r.m_leaves[depth - 1]);
+            failures += !ok;
+            std::cout << r.m_holes << 'x' << r.m_beans << " depth " << depth << ": " << n
+                      << (ok ? " ok" : " WRONG, expected ") ;
+            if (!ok)
+                std::cout << r.m_leaves[depth - 1];
+            std::cout << " (" << secondsSince(start) << "s)" << std::endl;
+        }
+    std::cout << (failures == 0 ? "all counts match" : "some counts are wrong") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int threads = 1;
+    bool divide = false, checkTable = false;
+    Side s = SOUTH;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "-d") == 0)
+            divide = true;
+        else if (std::strcmp(argv[i], "-n") == 0)
+            s = NORTH;
+        else if (std::strcmp(argv[i], "-c") == 0)
+            checkTable = true;
+        else
+            break;
+    }
+    if (checkTable)
+        return check(threads);
+    Board b(1, 0);
+    int depth = (i < argc ? std::atoi(argv[i]) : -1);
+    bool ok = false;
+    if (depth >= 0 && argc - i == 3)
+    {
+        int nHoles = std::atoi(argv[i + 1]);
+        int nBeans = std::atoi(argv[i + 2]);
+        ok = (nHoles > 0 && nBeans >= 0);
+        b = Board(nHoles, nBeans);
+    }
+    else if (depth >= 0 && argc - i == 2)
+        ok = parsePosition(argv[i + 1], b);
+    if (!ok)
+    {
+        std::cerr << "usage: " << argv[0] << " [-t threads] [-d] [-n] depth holes beans" << std::endl
+                  << "       " << argv[0] << " [-t threads] [-d] [-n] depth s1,...,sN,southPot,n1,...,nN,northPot"
+                  << std::endl
+                  << "       " << argv[0] << " [-t threads] -c" << std::endl;
+        return 2;
+    }
+    std::vector<PerftTurn> turns;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::uint64_t n = perft(b, s, depth, threads, divide ? &turns : nullptr);
+    double t = secondsSince(start);
+    for (size_t k = 0; k < turns.size(); k++)
+    {
+        for (size_t h = 0; h < turns[k].m_holes.size(); h++)
+            std::cout << (h > 0 ? " " : "") << turns[k].m_holes[h];
+        std::cout << ": " << turns[k].m_leaves << std::endl;
+    }
+    std::cout << "depth " << depth << ": " << n << " leaves in " << t << "s ("
+              << (t > 0 ? static_cast<std::uint64_t>(n / t) : 0) << " leaves/s)" << std::endl;
+    return 0;
+}
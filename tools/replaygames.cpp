@@ -0,0 +1,84 @@
+//==========================================================================
+// replaygames: replay every game in a record file (see GameRecord.h) and print how many there
+// were, how they ended, and how fast they were replayed; or, given a game's number (counting
+// from 1), print that game's players and sowings and the board after each.
+//
+//     replaygames file [game]
+//
+// Build it from the top directory of the project with
+//
+//     g++ -std=c++17 -O2 -o replaygames tools/replaygames.cpp GameRecord.cpp GameObserver.cpp Player.cpp Board.cpp TranspositionTable.cpp EndgameDatabase.cpp OpeningBook.cpp ThreadPool.cpp -pthread
+//==========================================================================
+
+#include "../GameRecord.h"
+#include "../GameObserver.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "usage: " << argv[0] << " file [game]" << std::endl;
+        return 2;
+    }
+    GameRecordReader reader;
+    if (!reader.open(argv[1]))
+    {
+        std::cerr << "couldn't open the record file " << argv[1] << std::endl;
+        return 1;
+    }
+    long wanted = (argc > 2 ? std::atol(argv[2]) : 0);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    long games = 0, sowings = 0, illegal = 0;
+    long results[3] = { 0, 0, 0 }; // SOUTH wins, NORTH wins, ties
+    GameRecordReader::Entry entry;
+    Board b(1, 0);
+    while (reader.next(entry))
+    {
+        games++;
+        if (wanted != 0 && games != wanted)
+            continue;
+        bool legal;
+        if (wanted != 0)
+        {
+            std::cout << entry.southName() << " (SOUTH) vs " << entry.northName() << " (NORTH)"
+                      << std::endl;
+            legal = entry.replay(b, [&](const Board& after, Side s, int hole) {
+                std::cout << "-----" << std::endl << (s == SOUTH ? entry.southName() : entry.northName())
+                          << " sows hole " << hole << ":" << std::endl << std::endl;
+                ConsoleObserver::drawBoard(std::cout, after, entry.southName(), entry.northName());
+                std::cout << std::endl;
+            });
+        }
+        else
+            legal = entry.replay(b);
+        sowings += entry.sowings();
+        if (!legal)
+        {
+            illegal++;
+            continue;
+        }
+        // each side gets the beans left on its side
+        int margin = b.beans(SOUTH, POT) + b.beansInPlay(SOUTH) - b.beans(NORTH, POT)
+                     - b.beansInPlay(NORTH);
+        results[margin > 0 ? 0 : (margin < 0 ? 1 : 2)]++;
+    }
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (reader.damaged())
+        std::cerr << "the file ends with a damaged record after game " << games << std::endl;
+    if (wanted != 0)
+    {
+        if (wanted > games)
+            std::cerr << "there are only " << games << " games in " << argv[1] << std::endl;
+        return wanted > games ? 1 : 0;
+    }
+    std::cout << games << " games, " << sowings << " sowings: SOUTH won " << results[0]
+              << ", NORTH won " << results[1] << ", " << results[2] << " ties";
+    if (illegal > 0)
+        std::cout << ", " << illegal << " with an illegal sowing";
+    std::cout << std::endl << "replayed in " << t << "s ("
+              << (t > 0 ? static_cast<long>(games / t) : 0) << " games/s)" << std::endl;
+    return illegal > 0 || reader.damaged() ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+//==========================================================================
+// solve: work out the exact result of perfect play from the standard starting position with a
+// given number of holes per side and beans per hole, and every first move that achieves it.
+//
+//     solve holes beans [megabytes [endgameFile]]
+//
+// uses a transposition table of about megabytes megabytes (256 if not given) and, if an endgame
+// database file made by makeendgame is given, looks up the positions it covers. Build it from the
+// top directory of the project with
+//
+//     g++ -std=c++17 -O2 -o solve tools/solve.cpp Solver.cpp Board.cpp TranspositionTable.cpp EndgameDatabase.cpp
+//==========================================================================
+
+#include "../Solver.h"
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 5)
+    {
+        std::cerr << "usage: " << argv[0] << " holes beans [megabytes [endgameFile]]" << std::endl;
+        return 2;
+    }
+    int nHoles = std::atoi(argv[1]);
+    int nBeans = std::atoi(argv[2]);
+    if (nHoles <= 0 || nBeans < 0)
+    {
+        std::cerr << "can't make a board with " << nHoles << " holes and " << nBeans << " beans"
+                  << std::endl;
+        return 2;
+    }
+    Solver solver(argc > 3 ? std::atoi(argv[3]) : 256);
+    if (argc > 4 && !solver.useEndgameDatabase(argv[4]))
+    {
+        std::cerr << "couldn't open the endgame database " << argv[4] << std::endl;
+        return 1;
+    }
+    Solver::Result result;
+    solver.solve(Board(nHoles, nBeans), SOUTH, SearchLimits(), result, &std::cout);
+    int margin = result.margin();
+    if (margin > 0)
+        std::cout << "SOUTH wins by " << margin;
+    else if (margin < 0)
+        std::cout << "NORTH wins by " << -margin;
+    else
+        std::cout << "draw";
+    std::cout << "; best first moves:";
+    for (size_t i = 0; i < result.m_bestMoves.size(); i++)
+        std::cout << ' ' << result.m_bestMoves[i];
+    std::cout << std::endl << result.m_nodes << " positions in " << result.m_seconds << "s ("
+              << result.nodesPerSecond() << "/s), " << result.m_passes << " passes" << std::endl;
+    return 0;
+}
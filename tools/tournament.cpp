@@ -0,0 +1,62 @@
+//==========================================================================
+// tournament: play a BadPlayer, a SmartPlayer and an MctsPlayer against each other, with no
+// display, games at a time on every processor core, and print each one's results and Elo
+// rating differences.
+//
+//     tournament holes beans games [msPerMove [threads [recordFile]]]
+//
+// plays games games between each pair of players, starting from Board(holes, beans), giving the
+// computer players msPerMove milliseconds a move (20 if not given), on threads threads (one per
+// core if not given), and adds a record of every game to recordFile if it's given (see
+// GameRecord.h and tools/replaygames.cpp). Every game gets new players, so the SmartPlayer's
+// transposition table is only 1MB: a search of a few milliseconds can't fill more, and setting up
+// a larger one for every game would be counted in the games per second. Build it from the top
+// directory of the project with
+//
+//     g++ -std=c++17 -O2 -pthread -o tournament tools/tournament.cpp Tournament.cpp Game.cpp GameObserver.cpp GameRecord.cpp Player.cpp Board.cpp TranspositionTable.cpp EndgameDatabase.cpp OpeningBook.cpp ThreadPool.cpp
+//==========================================================================
+
+#include "../Tournament.h"
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4 || argc > 7)
+    {
+        std::cerr << "usage: " << argv[0] << " holes beans games [msPerMove [threads [recordFile]]]"
+                  << std::endl;
+        return 2;
+    }
+    int nHoles = std::atoi(argv[1]);
+    int nBeans = std::atoi(argv[2]);
+    int nGames = std::atoi(argv[3]);
+    int msPerMove = (argc > 4 ? std::atoi(argv[4]) : 20);
+    int nThreads = (argc > 5 ? std::atoi(argv[5]) : 0);
+    if (nHoles <= 0 || nBeans < 0 || nGames <= 0 || msPerMove <= 0)
+    {
+        std::cerr << "holes, games and msPerMove must be positive" << std::endl;
+        return 2;
+    }
+    Tournament t(Board(nHoles, nBeans), nThreads);
+    GameRecordWriter records;
+    if (argc > 6)
+    {
+        if (!records.open(argv[6]))
+        {
+            std::cerr << "couldn't open the record file " << argv[6] << std::endl;
+            return 1;
+        }
+        t.setRecordWriter(&records);
+    }
+    t.addEntrant("Bad", []() { return std::unique_ptr<Player>(new BadPlayer("Bad")); });
+    t.addEntrant("Smart", [=]() {
+        return std::unique_ptr<Player>(new SmartPlayer("Smart", msPerMove, 0, 1, 1));
+    });
+    t.addEntrant("Mcts", [=]() {
+        return std::unique_ptr<Player>(new MctsPlayer("Mcts", msPerMove, 0, 1));
+    });
+    t.play(nGames, &std::cout);
+    t.report(std::cout);
+    return 0;
+}